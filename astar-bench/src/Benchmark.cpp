@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include "Graph/GraphJSON.h"
+#include "Graph/GraphBinary.h"
+#include "Pathfinding/AStar.h"
+#include "Pathfinding/HDAStar.h"
+#include "Pathfinding/HDAStarMessagePassing.h"
+#include "Pathfinding/BidirectionalAStar.h"
+#include "Pathfinding/ParallelBidirectionalAStar.h"
+#include "Pathfinding/Heuristics.h"
+#include "Profiling/Profiler.h"
+#include "Profiling/Timer.h"
+#include "StringUtil.h"
+
+namespace {
+	using Graph = CompressedGraph<Vec2, float>;
+
+	// Algorithm with the heuristic fixed in place of the one it's passed, so that the heuristic can be inlined into the search
+	// (the same as the specialised algorithms in PathfindingSettings). Empty if the name isn't known
+	template<class HeuristicFunc>
+	PathfindingAlgorithm<Vec2, float> algorithmWithHeuristic(const std::string& name, const HeuristicFunc& heuristic, const ContractionHierarchy<float>* contractionHierarchy) {
+		auto bind = [&heuristic](auto search) -> PathfindingAlgorithm<Vec2, float> {
+			return [search, heuristic](const Graph& graph, int start, int goal, const Heuristic<Vec2, float>&, SearchContext<float>& context) {
+				return search(graph, start, goal, heuristic, context);
+			};
+		};
+
+		if (name == "astar") { return bind([](const auto& graph, int start, int goal, const auto& h, auto& context) { return aStarSequential(graph, start, goal, h, context); }); }
+		if (name == "astar-radix") { return bind([](const auto& graph, int start, int goal, const auto& h, auto& context) { return aStarSequential<Graph, RadixHeapOpenSet>(graph, start, goal, h, context); }); }
+		if (name == "hda") { return bind([](const auto& graph, int start, int goal, const auto& h, auto& context) { return hashDistributedAStarSharedMemory(graph, start, goal, h, context); }); }
+		if (name == "hda-mp") { return bind([](const auto& graph, int start, int goal, const auto& h, auto& context) { return hashDistributedAStarMessagePassing(graph, start, goal, h, context); }); }
+		if (name == "nba") { return bind([](const auto& graph, int start, int goal, const auto& h, auto& context) { return bidirectionalAStar(graph, start, goal, h, context); }); }
+		if (name == "pnba") { return bind([](const auto& graph, int start, int goal, const auto& h, auto& context) { return parallelBidirectionalAStar(graph, start, goal, h, context); }); }
+		if (name == "ch") {
+			return [contractionHierarchy](const Graph&, int start, int goal, const Heuristic<Vec2, float>&, SearchContext<float>& context) { return contractionHierarchy->query(start, goal, context); };
+		}
+		return {};
+	}
+
+	// Whether thread count makes any difference to the algorithm's searches (for the contraction hierarchy it only affects preprocessing)
+	bool usesThreadCount(const std::string& algorithm) { return algorithm == "hda" || algorithm == "hda-mp"; }
+	// Whether the algorithm uses the heuristic at all
+	bool usesHeuristic(const std::string& algorithm) { return algorithm != "ch"; }
+
+	double pathCost(const Graph& graph, const Path& path) {
+		double cost = 0.0;
+		for (size_t i = 1; i < path.size(); ++i) {
+			for (auto [neighbour, weight] : graph.adjacency(path[i - 1])) {
+				if (neighbour == path[i]) { cost += weight; break; }
+			}
+		}
+		return cost;
+	}
+}
+
+Benchmark::Benchmark(const BenchmarkOptions& options) : m_options(options) {}
+
+bool Benchmark::prepare(std::string& error) {
+	return loadGraph(error) && loadQueries(error);
+}
+
+bool Benchmark::loadGraph(std::string& error) {
+	std::filesystem::path path(m_options.graphPath);
+	if (!std::filesystem::exists(path)) { error = stringOut("No such file ", m_options.graphPath); return false; }
+
+	Timer timer;
+	timer.start();
+	if (isBinaryGraphFile(path)) {
+		// Searched in place, straight out of the mapped file
+		auto mapped = mapBinaryFile<Vec2, float>(path);
+		if (!mapped) { error = stringOut("Invalid binary graph ", m_options.graphPath); return false; }
+		m_graph = std::move(*mapped);
+	}
+	else {
+		auto [graph, resultingPath] = loadFromFile<Vec2, float>(m_options.graphPath);
+		if (graph.size() == 0) { error = stringOut("Couldn't load a graph from ", resultingPath.generic_string()); return false; }
+		m_graph = CompressedGraph<Vec2, float>(graph);
+	}
+	timer.stop();
+	std::cerr << "Loaded " << m_graph.size() << " nodes and " << m_graph.numEdges() << " edges in " << timer.elapsedTime() << std::endl;
+	return true;
+}
+
+bool Benchmark::loadQueries(std::string& error) {
+	int numNodes = static_cast<int>(m_graph.size());
+
+	if (m_options.start != -1) {
+		auto valid = [numNodes](int index) { return index >= 0 && index < numNodes; };
+		if (!valid(m_options.start) || !valid(m_options.goal)) {
+			error = stringOut("Query ", m_options.start, " -> ", m_options.goal, " is outside the graph's ", numNodes, " nodes");
+			return false;
+		}
+		m_queries = QuerySet({ Query{ m_options.start, m_options.goal } });
+	}
+	else if (!m_options.queryFile.empty()) {
+		auto loaded = QuerySet::load(m_options.queryFile, numNodes, error);
+		if (!loaded) { return false; }
+		m_queries = std::move(*loaded);
+	}
+	else if (m_options.numDistanceBands > 0) {
+		m_queries = QuerySet::distanceBanded(m_graph, m_options.numRandomQueries, m_options.numDistanceBands, m_options.seed);
+		if (m_queries.size() < m_options.numRandomQueries) {
+			std::cerr << "Only found " << m_queries.size() << " of " << m_options.numRandomQueries << " queries, as some distance bands are too rare to fill" << std::endl;
+		}
+	}
+	else {
+		m_queries = QuerySet::uniform(numNodes, m_options.numRandomQueries, m_options.seed);
+	}
+	return true;
+}
+
+std::vector<BenchmarkResult> Benchmark::run() {
+	std::vector<BenchmarkResult> results;
+	for (auto& algorithm : m_options.algorithms) {
+		// Combinations which would only repeat the same searches are run once
+		std::vector<std::string> heuristics = usesHeuristic(algorithm) ? m_options.heuristics : std::vector<std::string>{ "none" };
+		std::vector<int> threadCounts = usesThreadCount(algorithm) ? m_options.threadCounts : std::vector<int>{ 1 };
+		for (auto& heuristic : heuristics) {
+			for (int threads : threadCounts) {
+				auto combinationResults = runCombination(algorithm, heuristic, threads);
+				results.insert(results.end(), combinationResults.begin(), combinationResults.end());
+			}
+		}
+	}
+	return results;
+}
+
+std::vector<BenchmarkResult> Benchmark::runCombination(const std::string& algorithm, const std::string& heuristic, int threads) {
+	// Build preprocessed data on first use
+	if (heuristic == "alt" && !m_landmarks) {
+		Timer timer;
+		timer.start();
+		m_landmarks.emplace(m_graph, m_options.numLandmarks, LandmarkSelection::Farthest, m_options.seed);
+		timer.stop();
+		std::cerr << "Precomputed distances for " << m_landmarks->landmarks().size() << " landmarks in " << timer.elapsedTime() << std::endl;
+	}
+	if (algorithm == "ch" && !m_contractionHierarchy) {
+		int buildThreads = *std::max_element(m_options.threadCounts.begin(), m_options.threadCounts.end());
+		Timer timer;
+		timer.start();
+		m_contractionHierarchy.emplace(m_graph, buildThreads);
+		timer.stop();
+		std::cerr << "Built contraction hierarchy with " << m_contractionHierarchy->numShortcuts() << " shortcuts in " << timer.elapsedTime() << " using " << buildThreads << " threads" << std::endl;
+	}
+
+	PathfindingAlgorithm<Vec2, float> search;
+	const ContractionHierarchy<float>* contractionHierarchy = m_contractionHierarchy ? &*m_contractionHierarchy : nullptr;
+	if (heuristic == "euclidean") { search = algorithmWithHeuristic(algorithm, DistanceHeuristic<EuclideanDistance>(), contractionHierarchy); }
+	else if (heuristic == "manhattan") { search = algorithmWithHeuristic(algorithm, DistanceHeuristic<ManhattanDistance>(), contractionHierarchy); }
+	else {
+		const Landmarks<float>* landmarks = m_landmarks ? &*m_landmarks : nullptr;
+		search = algorithmWithHeuristic(algorithm, [landmarks](const Graph&, int from, int to) { return landmarks ? landmarks->lowerBound(from, to) : 0.f; }, contractionHierarchy);
+	}
+
+	g_numThreads = threads;
+	// Every algorithm above has its heuristic built in, so this is never called
+	Heuristic<Vec2, float> unusedHeuristic;
+	SearchContext<float> context;
+	context.heuristicCache().setPrefill(m_options.prefillHeuristic);
+
+	std::vector<BenchmarkResult> results;
+	for (int query = 0; query < m_queries.size(); ++query) {
+		auto [start, goal] = m_queries.queries()[query];
+		std::cerr << "\r" << algorithm << " / " << heuristic << " / " << threads << " threads: query " << (query + 1) << " of " << m_queries.size() << std::flush;
+
+		ProfilerBlocking profiler(m_options.iterations);
+		profiler.performProfiling(search, std::cref(m_graph), start, goal, std::cref(unusedHeuristic), std::ref(context));
+
+		// One more (untimed) run to see what was found
+		Path path = search(m_graph, start, goal, unusedHeuristic, context);
+		results.push_back(BenchmarkResult{ algorithm, heuristic, threads, query, start, goal, path.size(), pathCost(m_graph, path), profiler.timingResults() });
+	}
+	std::cerr << std::endl;
+	return results;
+}
+
+namespace {
+	struct Summary { long long mean, standardDeviation, min, max, median, p90, p99; };
+
+	Summary summarise(const TimeStatistics& times) {
+		auto count = [](const TimeCompound& time) { return static_cast<long long>(time.asNanosecondsFull().count()); };
+		return Summary{ count(times.mean()), count(times.standardDeviation()), count(times.min()), count(times.max()),
+			count(times.median()), count(times.percentile(0.9)), count(times.percentile(0.99)) };
+	}
+}
+
+void writeResultsCSV(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+	out << "algorithm,heuristic,threads,query,start,goal,path_nodes,path_cost,iterations,mean_ns,stddev_ns,min_ns,max_ns,median_ns,p90_ns,p99_ns\n";
+	for (auto& result : results) {
+		Summary summary = summarise(result.times);
+		out << result.algorithm << ',' << result.heuristic << ',' << result.threads << ',' << result.query << ',' << result.start << ',' << result.goal << ','
+			<< result.pathNodes << ',' << result.pathCost << ',' << result.times.times().size() << ','
+			<< summary.mean << ',' << summary.standardDeviation << ',' << summary.min << ',' << summary.max << ','
+			<< summary.median << ',' << summary.p90 << ',' << summary.p99 << '\n';
+	}
+}
+
+void writeResultsJSON(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+	json data = json::array();
+	for (auto& result : results) {
+		Summary summary = summarise(result.times);
+		json times = json::array();
+		for (auto& time : result.times.times()) { times.push_back(time.asNanosecondsFull().count()); }
+		data.push_back({
+			{ "algorithm", result.algorithm }, { "heuristic", result.heuristic }, { "threads", result.threads },
+			{ "query", result.query }, { "start", result.start }, { "goal", result.goal },
+			{ "path_nodes", result.pathNodes }, { "path_cost", result.pathCost },
+			{ "mean_ns", summary.mean }, { "stddev_ns", summary.standardDeviation }, { "min_ns", summary.min }, { "max_ns", summary.max },
+			{ "median_ns", summary.median }, { "p90_ns", summary.p90 }, { "p99_ns", summary.p99 },
+			{ "times_ns", times } });
+	}
+	out << data.dump(1, '\t') << '\n';
+}
\ No newline at end of file
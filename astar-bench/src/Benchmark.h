@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <optional>
+
+#include "BenchmarkOptions.h"
+
+#include "Graph/CompressedGraph.h"
+#include "Maths/Vec2.h"
+#include "Pathfinding/Landmarks.h"
+#include "Pathfinding/ContractionHierarchy.h"
+#include "Profiling/TimeStatistics.h"
+#include "Profiling/QuerySet.h"
+
+// Timings of one query with one combination of algorithm, heuristic and thread count
+struct BenchmarkResult
+{
+	std::string algorithm, heuristic;
+	int threads;
+	int query, start, goal;
+	// Number of nodes in the path found (zero if none) and its total cost
+	size_t pathNodes;
+	double pathCost;
+	TimeStatistics times;
+};
+
+// Runs every combination of algorithms, heuristics and thread counts from the options over every query, with no window involved.
+// Preprocessing (landmarks, contraction hierarchy) happens once, the first time it's needed, and isn't included in the timings
+class Benchmark
+{
+public:
+	Benchmark(const BenchmarkOptions& options);
+
+	// Load the graph and build the query set. Returns false and sets error if either fails
+	bool prepare(std::string& error);
+
+	std::vector<BenchmarkResult> run();
+
+	const CompressedGraph<Vec2, float>& graph() const { return m_graph; }
+	const QuerySet& queries() const { return m_queries; }
+
+private:
+	BenchmarkOptions m_options;
+	CompressedGraph<Vec2, float> m_graph;
+	QuerySet m_queries;
+
+	std::optional<Landmarks<float>> m_landmarks;
+	std::optional<ContractionHierarchy<float>> m_contractionHierarchy;
+
+	bool loadGraph(std::string& error);
+	bool loadQueries(std::string& error);
+
+	std::vector<BenchmarkResult> runCombination(const std::string& algorithm, const std::string& heuristic, int threads);
+};
+
+void writeResultsCSV(std::ostream& out, const std::vector<BenchmarkResult>& results);
+void writeResultsJSON(std::ostream& out, const std::vector<BenchmarkResult>& results);
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <charconv>
+
+#include "StringUtil.h"
+
+const std::vector<std::string>& benchmarkAlgorithmNames() {
+	static const std::vector<std::string> names = { "astar", "astar-radix", "hda", "hda-mp", "nba", "pnba", "ch" };
+	return names;
+}
+
+const std::vector<std::string>& benchmarkHeuristicNames() {
+	static const std::vector<std::string> names = { "euclidean", "manhattan", "alt" };
+	return names;
+}
+
+void printBenchmarkUsage(std::ostream& out) {
+	out << "Usage: astar-bench --graph <file> [options]\n"
+		"\n"
+		"Runs pathfinding algorithms over a graph with no window, and writes timings as CSV or JSON.\n"
+		"Every combination of algorithm, heuristic and thread count is run over every query.\n"
+		"\n"
+		"  --graph <file>          Graph to load, either JSON or binary (.graph)\n"
+		"  --algorithm <list>      Comma separated, or 'all' (default astar): astar, astar-radix, hda, hda-mp, nba, pnba, ch\n"
+		"  --heuristic <list>      Comma separated, or 'all' (default euclidean): euclidean, manhattan, alt\n"
+		"  --threads <list>        Comma separated thread counts (default one per core). Only affects parallel algorithms\n"
+		"  --iterations <n>        Timed runs of each query (default 10)\n"
+		"  --query <start> <goal>  Single query\n"
+		"  --queries <file>        File of queries, one 'start goal' pair per line ('#' starts a comment)\n"
+		"  --random <n>            Random queries, drawn uniformly from all nodes\n"
+		"  --bands <n>             Split random queries evenly between n bands of straight-line distance\n"
+		"  --seed <n>              Seed for random queries and landmark selection (default 0)\n"
+		"  --landmarks <n>         Number of landmarks for the alt heuristic (default 8)\n"
+		"  --prefill-heuristic     Evaluate the heuristic for every node up front in hda and hda-mp, in vectorised batches\n"
+		"  --format <csv|json>     Output format (default csv)\n"
+		"  --output <file>         Write results to file rather than standard output\n"
+		"  --help                  Show this message\n";
+}
+
+namespace {
+	std::vector<std::string> splitList(const std::string& list) {
+		std::vector<std::string> items;
+		std::stringstream stream(list);
+		std::string item;
+		while (std::getline(stream, item, ',')) { if (!item.empty()) { items.push_back(item); } }
+		return items;
+	}
+
+	bool parseInt(const std::string& text, int& out) {
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), out);
+		return error == std::errc() && end == text.data() + text.size();
+	}
+
+	// Expand 'all' and check every name is one we know
+	bool parseNames(const std::string& list, const std::vector<std::string>& known, std::vector<std::string>& out, const char* what, std::string& error) {
+		out.clear();
+		for (auto& name : splitList(list)) {
+			if (name == "all") { out.insert(out.end(), known.begin(), known.end()); continue; }
+			if (std::find(known.begin(), known.end(), name) == known.end()) { error = stringOut("Unknown ", what, " '", name, "'"); return false; }
+			out.push_back(name);
+		}
+		if (out.empty()) { error = stringOut("No ", what, " given"); return false; }
+		return true;
+	}
+}
+
+std::optional<BenchmarkOptions> parseBenchmarkOptions(int argc, char** argv, std::string& error) {
+	BenchmarkOptions options;
+	error.clear();
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		// Value following the current argument, failing if there isn't one
+		auto next = [&](std::string& value) {
+			if (i + 1 >= argc) { error = stringOut(arg, " expects a value"); return false; }
+			value = argv[++i];
+			return true;
+		};
+		auto nextInt = [&](int& value, int minimum) {
+			std::string text;
+			if (!next(text)) { return false; }
+			if (!parseInt(text, value) || value < minimum) { error = stringOut(arg, " expects a whole number of at least ", minimum, ", not '", text, "'"); return false; }
+			return true;
+		};
+
+		std::string value;
+		if (arg == "--help" || arg == "-h") { return std::nullopt; }
+		else if (arg == "--graph") { if (!next(options.graphPath)) { return std::nullopt; } }
+		else if (arg == "--algorithm") {
+			if (!next(value) || !parseNames(value, benchmarkAlgorithmNames(), options.algorithms, "algorithm", error)) { return std::nullopt; }
+		}
+		else if (arg == "--heuristic") {
+			if (!next(value) || !parseNames(value, benchmarkHeuristicNames(), options.heuristics, "heuristic", error)) { return std::nullopt; }
+		}
+		else if (arg == "--threads") {
+			if (!next(value)) { return std::nullopt; }
+			options.threadCounts.clear();
+			for (auto& item : splitList(value)) {
+				int threads;
+				if (!parseInt(item, threads) || threads < 1) { error = stringOut("Invalid thread count '", item, "'"); return std::nullopt; }
+				options.threadCounts.push_back(threads);
+			}
+		}
+		else if (arg == "--iterations") { if (!nextInt(options.iterations, 1)) { return std::nullopt; } }
+		else if (arg == "--query") { if (!nextInt(options.start, 0) || !nextInt(options.goal, 0)) { return std::nullopt; } }
+		else if (arg == "--queries") { if (!next(options.queryFile)) { return std::nullopt; } }
+		else if (arg == "--random") { if (!nextInt(options.numRandomQueries, 1)) { return std::nullopt; } }
+		else if (arg == "--bands") { if (!nextInt(options.numDistanceBands, 1)) { return std::nullopt; } }
+		else if (arg == "--seed") {
+			int seed;
+			if (!nextInt(seed, 0)) { return std::nullopt; }
+			options.seed = static_cast<unsigned int>(seed);
+		}
+		else if (arg == "--landmarks") { if (!nextInt(options.numLandmarks, 1)) { return std::nullopt; } }
+		else if (arg == "--prefill-heuristic") { options.prefillHeuristic = true; }
+		else if (arg == "--format") {
+			if (!next(value)) { return std::nullopt; }
+			if (value == "csv") { options.format = BenchmarkOptions::OutputFormat::CSV; }
+			else if (value == "json") { options.format = BenchmarkOptions::OutputFormat::JSON; }
+			else { error = stringOut("Unknown format '", value, "'"); return std::nullopt; }
+		}
+		else if (arg == "--output") { if (!next(options.outputPath)) { return std::nullopt; } }
+		else { error = stringOut("Unknown option '", arg, "'"); return std::nullopt; }
+	}
+
+	if (options.graphPath.empty()) { error = "No graph given"; return std::nullopt; }
+	int numQuerySources = (options.start != -1) + !options.queryFile.empty() + (options.numRandomQueries > 0);
+	if (numQuerySources != 1) { error = "Give exactly one of --query, --queries or --random"; return std::nullopt; }
+	if (options.numDistanceBands > 0 && options.numRandomQueries == 0) { error = "--bands only applies to --random"; return std::nullopt; }
+	if (options.threadCounts.empty()) { options.threadCounts.push_back(std::max(1, static_cast<int>(std::thread::hardware_concurrency()))); }
+
+	return options;
+}
\ No newline at end of file
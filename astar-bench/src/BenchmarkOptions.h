@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <ostream>
+
+// Everything the benchmark runner can be told on the command line. Each combination of algorithm, heuristic and thread count
+// is run over every query in the query set
+struct BenchmarkOptions
+{
+	enum class OutputFormat { CSV, JSON };
+
+	std::string graphPath;
+
+	std::vector<std::string> algorithms = { "astar" };
+	std::vector<std::string> heuristics = { "euclidean" };
+	std::vector<int> threadCounts;
+	int iterations = 10;
+
+	// Query set: an explicit start and goal, a file of start/goal pairs, or a number of random pairs
+	int start = -1, goal = -1;
+	std::string queryFile;
+	int numRandomQueries = 0;
+	// Random queries are split evenly between this many bands of straight-line distance, or drawn uniformly if zero
+	int numDistanceBands = 0;
+	unsigned int seed = 0;
+
+	int numLandmarks = 8;
+	// Have hda and hda-mp evaluate the heuristic for every node at the start of each query, rather than as nodes are reached
+	bool prefillHeuristic = false;
+
+	OutputFormat format = OutputFormat::CSV;
+	// Standard output if empty
+	std::string outputPath;
+};
+
+// Parse argv into options. On failure returns nothing and sets error, unless help was asked for, in which case error is left empty
+std::optional<BenchmarkOptions> parseBenchmarkOptions(int argc, char** argv, std::string& error);
+
+void printBenchmarkUsage(std::ostream& out);
+
+// Names accepted by --algorithm and --heuristic
+const std::vector<std::string>& benchmarkAlgorithmNames();
+const std::vector<std::string>& benchmarkHeuristicNames();
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <fstream>
+
+#include "BenchmarkOptions.h"
+#include "Benchmark.h"
+
+// Headless benchmark runner: loads a graph, runs the requested algorithms over a set of queries and writes the timings out,
+// without opening a window, so it can be run on machines with no display
+int main(int argc, char** argv) {
+	std::string error;
+	auto options = parseBenchmarkOptions(argc, argv, error);
+	if (!options) {
+		if (!error.empty()) { std::cerr << "astar-bench: " << error << "\n\n"; }
+		printBenchmarkUsage(error.empty() ? std::cout : std::cerr);
+		return error.empty() ? 0 : 2;
+	}
+
+	Benchmark benchmark(*options);
+	if (!benchmark.prepare(error)) {
+		std::cerr << "astar-bench: " << error << std::endl;
+		return 1;
+	}
+
+	auto results = benchmark.run();
+
+	std::ofstream file;
+	if (!options->outputPath.empty()) {
+		file.open(options->outputPath, std::ios::binary);
+		if (!file.is_open()) { std::cerr << "astar-bench: Couldn't open " << options->outputPath << " for writing" << std::endl; return 1; }
+	}
+	std::ostream& out = file.is_open() ? file : std::cout;
+
+	if (options->format == BenchmarkOptions::OutputFormat::JSON) { writeResultsJSON(out, results); }
+	else { writeResultsCSV(out, results); }
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+#include <memory>
+#include <mutex>
+#include <concepts>
+
+#include "DirectedGraph.h"
+
+// Frozen compressed-sparse-row copy of a DirectedGraph.
+// The outgoing edges of node i are stored contiguously at [offsets[i], offsets[i+1]) in the target and weight arrays,
+// so iterating a node's neighbours is a linear walk over memory rather than a red-black tree traversal.
+// Incoming edges are stored the same way, for searches which need to run backwards from the goal.
+// The arrays can also live outside the graph (eg. in a memory-mapped binary graph file), in which case it's just a view over them.
+template<class ValueType, class WeightType = int>
+class CompressedGraph
+{
+public:
+	using value_type = ValueType;
+	using weight_type = WeightType;
+
+	struct Edge { int index; WeightType weight; };
+
+	// Iterable view over the outgoing edges of a single node, yielding Edges so it can be used
+	// with the same structured bindings as a DirectedGraph adjacency map
+	class AdjacencyRange
+	{
+	public:
+		class iterator
+		{
+		public:
+			iterator(const int* target, const WeightType* weight) : m_target(target), m_weight(weight) {}
+
+			Edge operator*() const { return Edge{ *m_target, *m_weight }; }
+			iterator& operator++() { ++m_target; ++m_weight; return *this; }
+			bool operator==(const iterator& other) const { return m_target == other.m_target; }
+			bool operator!=(const iterator& other) const { return m_target != other.m_target; }
+
+		private:
+			const int* m_target; const WeightType* m_weight;
+		};
+
+		AdjacencyRange(const int* targets, const WeightType* weights, int count) : m_targets(targets), m_weights(weights), m_count(count) {}
+
+		iterator begin() const { return iterator(m_targets, m_weights); }
+		iterator end() const { return iterator(m_targets + m_count, m_weights + m_count); }
+
+		int size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+
+	private:
+		const int* m_targets; const WeightType* m_weights;
+		int m_count;
+	};
+
+	// Raw arrays making up the graph, which are either owned by the CompressedGraph itself or by something else, eg. a memory-mapped file
+	struct Arrays {
+		const ValueType* values; const int* offsets; const int* targets; const WeightType* weights;
+		const int* reverseOffsets; const int* reverseSources; const WeightType* reverseWeights;
+		size_t numNodes, numEdges;
+	};
+
+	CompressedGraph() { m_storage.offsets = { 0 }; m_storage.reverseOffsets = { 0 }; bindStorage(); }
+	explicit CompressedGraph(const DirectedGraph<ValueType, WeightType>& graph) : m_sourceRevision(graph.revision()) {
+		size_t numEdges = 0;
+		for (int i = 0; i < graph.size(); ++i) { numEdges += graph.adjacency(i).size(); }
+
+		m_storage.values.reserve(graph.size()); m_storage.offsets.reserve(graph.size() + 1);
+		m_storage.targets.reserve(numEdges); m_storage.weights.reserve(numEdges);
+
+		m_storage.offsets.push_back(0);
+		for (int i = 0; i < graph.size(); ++i) {
+			m_storage.values.push_back(graph.value(i));
+			// Adjacency maps are ordered by index, so neighbours end up sorted within each row
+			for (auto& [neighbour, weight] : graph.adjacency(i)) {
+				m_storage.targets.push_back(neighbour);
+				m_storage.weights.push_back(weight);
+			}
+			m_storage.offsets.push_back(static_cast<int>(m_storage.targets.size()));
+		}
+
+		buildReverseEdges();
+		bindStorage();
+	}
+	// View over arrays held elsewhere, without copying them. Backing is kept alive for as long as any copy of the graph is
+	CompressedGraph(const Arrays& arrays, std::shared_ptr<const void> backing, unsigned long long sourceRevision = 0)
+		: m_arrays(arrays), m_backing(std::move(backing)), m_sourceRevision(sourceRevision) {}
+
+	// Views are copied as views; anything else copies its arrays and points at the new ones
+	CompressedGraph(const CompressedGraph& other) : m_storage(other.m_storage), m_arrays(other.m_arrays), m_backing(other.m_backing), m_sourceRevision(other.m_sourceRevision),
+		m_coordinates(other.m_coordinates) {
+		if (!m_backing) { bindStorage(); }
+	}
+	CompressedGraph(CompressedGraph&& other) noexcept : m_storage(std::move(other.m_storage)), m_arrays(other.m_arrays), m_backing(std::move(other.m_backing)), m_sourceRevision(other.m_sourceRevision),
+		m_coordinates(other.m_coordinates) {
+		if (!m_backing) { bindStorage(); }
+	}
+	CompressedGraph& operator=(const CompressedGraph& other) {
+		if (this != &other) { *this = CompressedGraph(other); }
+		return *this;
+	}
+	CompressedGraph& operator=(CompressedGraph&& other) noexcept {
+		m_storage = std::move(other.m_storage); m_arrays = other.m_arrays; m_backing = std::move(other.m_backing);
+		m_sourceRevision = other.m_sourceRevision; m_coordinates = other.m_coordinates;
+		if (!m_backing) { bindStorage(); }
+		return *this;
+	}
+
+	bool has(int index) const { return index >= 0 && index < m_arrays.numNodes; }
+
+	size_t size() const { return m_arrays.numNodes; }
+	size_t numEdges() const { return m_arrays.numEdges; }
+
+	const ValueType& value(int index) const { return m_arrays.values[index]; }
+	AdjacencyRange adjacency(int index) const {
+		int first = m_arrays.offsets[index];
+		return AdjacencyRange(m_arrays.targets + first, m_arrays.weights + first, m_arrays.offsets[index + 1] - first);
+	}
+
+	// Edges coming into index, yielding the index of the node each starts from
+	AdjacencyRange reverseAdjacency(int index) const {
+		int first = m_arrays.reverseOffsets[index];
+		return AdjacencyRange(m_arrays.reverseSources + first, m_arrays.reverseWeights + first, m_arrays.reverseOffsets[index + 1] - first);
+	}
+
+	// Whether values are points (anything with float x and y members, eg. Vec2), in which case their coordinates can also be read
+	// split into separate x and y arrays, so batch kernels can stream through them with vector loads.
+	// The arrays are built the first time either is asked for and shared by copies, so graphs nothing batches over don't pay for them
+	static constexpr bool hasCoordinates = requires(const ValueType& value) { { value.x } -> std::convertible_to<float>; { value.y } -> std::convertible_to<float>; };
+	const float* xs() const { return coordinates().xs.data(); }
+	const float* ys() const { return coordinates().ys.data(); }
+
+	const Arrays& arrays() const { return m_arrays; }
+	// Whatever owns the arrays of a view, or null if the graph owns its own
+	const std::shared_ptr<const void>& backing() const { return m_backing; }
+
+	// Revision of the DirectedGraph this was built from
+	unsigned long long sourceRevision() const { return m_sourceRevision; }
+
+private:
+	struct Storage {
+		std::vector<ValueType> values;
+		std::vector<int> offsets;
+		std::vector<int> targets;
+		std::vector<WeightType> weights;
+
+		std::vector<int> reverseOffsets;
+		std::vector<int> reverseSources;
+		std::vector<WeightType> reverseWeights;
+	};
+	// Only used when the graph owns its arrays
+	Storage m_storage;
+
+	Arrays m_arrays{};
+	std::shared_ptr<const void> m_backing;
+
+	unsigned long long m_sourceRevision = 0;
+
+	// Copies of the coordinates of every value, owned even when the rest of the graph is a view
+	struct Coordinates {
+		std::once_flag built;
+		std::vector<float> xs, ys;
+	};
+	std::shared_ptr<Coordinates> m_coordinates = std::make_shared<Coordinates>();
+
+	// Safe to call from several threads at once; only the first builds the arrays
+	const Coordinates& coordinates() const {
+		static_assert(hasCoordinates, "Only graphs of points have coordinate arrays.");
+		std::call_once(m_coordinates->built, [this]() {
+			m_coordinates->xs.resize(m_arrays.numNodes); m_coordinates->ys.resize(m_arrays.numNodes);
+			for (size_t i = 0; i < m_arrays.numNodes; ++i) { m_coordinates->xs[i] = m_arrays.values[i].x; m_coordinates->ys[i] = m_arrays.values[i].y; }
+		});
+		return *m_coordinates;
+	}
+
+	void bindStorage() {
+		m_arrays = Arrays{
+			m_storage.values.data(), m_storage.offsets.data(), m_storage.targets.data(), m_storage.weights.data(),
+			m_storage.reverseOffsets.data(), m_storage.reverseSources.data(), m_storage.reverseWeights.data(),
+			m_storage.values.size(), m_storage.targets.size() };
+	}
+
+	// Transpose the forward arrays. Sources are visited in order, so each row of incoming edges ends up sorted too
+	void buildReverseEdges() {
+		size_t numNodes = m_storage.values.size(), numEdges = m_storage.targets.size();
+		m_storage.reverseOffsets.assign(numNodes + 1, 0);
+		for (int target : m_storage.targets) { ++m_storage.reverseOffsets[target + 1]; }
+		for (int i = 0; i < numNodes; ++i) { m_storage.reverseOffsets[i + 1] += m_storage.reverseOffsets[i]; }
+
+		m_storage.reverseSources.resize(numEdges); m_storage.reverseWeights.resize(numEdges);
+		std::vector<int> insertPosition(m_storage.reverseOffsets.begin(), m_storage.reverseOffsets.end() - 1);
+		for (int source = 0; source < numNodes; ++source) {
+			for (int edge = m_storage.offsets[source]; edge < m_storage.offsets[source + 1]; ++edge) {
+				int position = insertPosition[m_storage.targets[edge]]++;
+				m_storage.reverseSources[position] = source;
+				m_storage.reverseWeights[position] = m_storage.weights[edge];
+			}
+		}
+	}
+};
+
+// Editable copy of a compressed graph
+template<class ValueType, class WeightType>
+DirectedGraph<ValueType, WeightType> decompress(const CompressedGraph<ValueType, WeightType>& graph) {
+	DirectedGraph<ValueType, WeightType> result;
+	for (int i = 0; i < graph.size(); ++i) { result.createNode(graph.value(i)); }
+	for (int i = 0; i < graph.size(); ++i) {
+		for (auto [neighbour, weight] : graph.adjacency(i)) { result.setEdgeWeight(i, neighbour, weight); }
+	}
+	return result;
+}
\ No newline at end of file
@@ -8,6 +8,9 @@ template<class ValueType, class WeightType = int>
 class DirectedGraph
 {
 public:
+	using value_type = ValueType;
+	using weight_type = WeightType;
+
 	class Node {
 	public:
 		Node(const ValueType& value) : m_value(value) {}
@@ -37,20 +40,35 @@ public:
 	bool has(int index) const { return index >= 0 && index < m_nodes.size(); }
 
 	size_t size() const { return m_nodes.size(); }
+	void reserve(size_t numNodes) { m_nodes.reserve(numNodes); }
+
+	// Adjacency-range interface shared with CompressedGraph, so pathfinding algorithms can run against either
+	const ValueType& value(int index) const { return m_nodes.at(index).value(); }
+	const std::map<int, WeightType>& adjacency(int index) const { return m_nodes.at(index).adjacencyMap(); }
 
-	int createNode(ValueType val) { m_nodes.push_back(Node(val)); return m_nodes.size(); }
-	void setValue(int index, ValueType val) { m_nodes[index].setValue(val); }
+	// Changes whenever the graph is modified. Revisions are drawn from a shared counter, so two graphs with
+	// different contents never share one (used to tell when derived structures like a CompressedGraph are stale)
+	unsigned long long revision() const { return m_revision; }
+
+	int createNode(ValueType val) { m_nodes.push_back(Node(val)); touch(); return m_nodes.size(); }
+	void setValue(int index, ValueType val) { m_nodes[index].setValue(val); touch(); }
 	void setEdgeWeight(int start, int end, WeightType weight, bool twoWay = false) {
 		if (start < 0 || start >= size() || end < 0 || end >= size()) { throw std::out_of_range("Edge contains invalid indices."); }
 		m_nodes[start].setEdgeWeight(end, weight);
 		if (twoWay) { m_nodes[end].setEdgeWeight(start, weight); }
+		touch();
 	}
 	void removeEdge(int start, int end, bool twoWay = false) {
 		if (start < 0 || start >= size() || end < 0 || end >= size()) { throw std::out_of_range("Edge contains invalid indices."); }
 		m_nodes[start].removeEdge(end);
 		if (twoWay) { m_nodes[end].removeEdge(start); }
+		touch();
 	}
 
 private:
 	std::vector<Node> m_nodes;
+
+	static inline unsigned long long s_revisionCounter = 0;
+	unsigned long long m_revision = ++s_revisionCounter;
+	void touch() { m_revision = ++s_revisionCounter; }
 };
\ No newline at end of file
@@ -2,41 +2,62 @@
 
 #include "DirectedGraph.h"
 #include "../Maths/Vec2.h"
+#include "../Maths/PointGrid.h"
 #include <functional>
 #include <random>
-#include <queue>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include "../Pathfinding/Heuristics.h"
+#include "../Threading/ThreadPool.h"
 
+// The same seed always gives the same graph, whatever the number of threads (0 meaning one per core).
+// Node positions are drawn on one thread from a single generator; the neighbour searches are split across the thread pool
+// and their results merged into the graph in node order afterwards.
 template<class distribution = std::uniform_real_distribution<float>>
-DirectedGraph<Vec2, float> GenerateKNearest(int numNodes, int k, Vec2 min, Vec2 max, const Heuristic<Vec2,float>& distanceFunc, bool doubleEdged = false) {
+DirectedGraph<Vec2, float> GenerateKNearest(int numNodes, int k, Vec2 min, Vec2 max, const DistanceFunction<Vec2,float>& distanceFunc, unsigned int seed, bool doubleEdged = false, int numThreads = 0) {
 	DirectedGraph<Vec2, float> graph;
 
-	std::random_device rd;  // Will be used to obtain a seed for the random number engine
-	std::mt19937 gen(rd()); // Standard mersenne_twister_engine seeded with rd()
+	std::mt19937 gen(seed); // Standard mersenne_twister_engine seeded explicitly so graphs can be reproduced
 	distribution x_distribution(min.x,max.x), y_distribution(min.y, max.y);
 
+	std::vector<Vec2> positions;
+	positions.reserve(numNodes);
 	for (int i = 0; i < numNodes; ++i) {
-		graph.createNode(Vec2(x_distribution(gen), y_distribution(gen)));
+		// Drawn in separate statements so the order (and so the graph for a given seed) doesn't depend on the compiler
+		float x = x_distribution(gen);
+		float y = y_distribution(gen);
+		positions.emplace_back(x, y);
+		graph.createNode(positions.back());
 	}
 
-	struct indexDist { int index; float distance; indexDist(int index, float distance) : index(index), distance(distance) {} };
-	auto comp = [](const indexDist& lhs, const indexDist& rhs) { return lhs.distance > rhs.distance; };
+	// Grid lookup only compares each node against its surroundings, rather than every other node
+	PointGrid grid(positions);
 
-	for (int i = 0; i < numNodes; ++i) {
-		Vec2 rootPos = graph.at(i).value();
+	// Each node's neighbours go in its own fixed-size slot, so threads never write to the same place
+	k = std::clamp(k, 0, std::max(numNodes - 1, 0));
+	std::vector<int> neighbours(static_cast<size_t>(numNodes) * k);
 
-		std::priority_queue<indexDist, std::vector<indexDist>, decltype(comp)> queue(comp);
-		for (int j = 0; j < numNodes; ++j) {
-			if (j == i) { continue; }
-			Vec2 otherPos = graph.at(j).value();
-			queue.push(indexDist(j, distanceFunc(rootPos, otherPos)));
+	if (numThreads <= 0) { numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency())); }
+	// Nodes are handed out in blocks, which keeps the shared counter out of the way but still balances uneven regions
+	constexpr int blockSize = 1024;
+	std::atomic<int> nextBlock = 0;
+	auto searchFunc = [&](int) {
+		std::vector<int> nearest;
+		for (int block = nextBlock++; block * blockSize < numNodes; block = nextBlock++) {
+			for (int i = block * blockSize; i < std::min(numNodes, (block + 1) * blockSize); ++i) {
+				grid.kNearest(i, k, distanceFunc, nearest);
+				std::copy(nearest.begin(), nearest.end(), neighbours.begin() + static_cast<size_t>(i) * k);
+			}
 		}
+	};
+	ThreadPool::shared().run(numThreads, searchFunc);
+
+	for (int i = 0; i < numNodes; ++i) {
 		for (int neighbour = 0; neighbour < k; ++neighbour) {
-			if (queue.empty()) { break; }
-			int endIndex = queue.top().index;
-			queue.pop();
-			graph.setEdgeWeight(i, endIndex, 1.f, doubleEdged);
+			graph.setEdgeWeight(i, neighbours[static_cast<size_t>(i) * k + neighbour], 1.f, doubleEdged);
 		}
 	}
 
@@ -0,0 +1,8 @@
+#include "GraphBinary.h"
+
+bool isBinaryGraphFile(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+	char magic[sizeof(binaryGraphMagic)];
+	if (!file.is_open() || !file.read(magic, sizeof(magic))) { return false; }
+	return std::memcmp(magic, binaryGraphMagic, sizeof(magic)) == 0;
+}
\ No newline at end of file
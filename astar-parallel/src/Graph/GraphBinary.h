@@ -0,0 +1,158 @@
+#pragma once
+
+#include "DirectedGraph.h"
+#include "CompressedGraph.h"
+#include "MappedFile.h"
+
+#include <fstream>
+#include <filesystem>
+#include <optional>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+// Binary graph file, laid out as a header followed by exactly the arrays of a CompressedGraph:
+//   [header][values][offsets][targets][weights][reverse offsets][reverse sources][reverse weights]
+// with each array starting on an 8 byte boundary at the position given in the header. Everything is in native byte order; the header
+// records that order, and a file from a machine with the other order is rejected rather than converted.
+// Since nothing needs decoding, a file can be memory-mapped and used as a graph in place (see mapBinaryFile).
+struct BinaryGraphHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byteOrderMark;
+	std::uint32_t valueSize, weightSize;
+	std::uint64_t numNodes, numEdges;
+	// Byte offsets of each array from the start of the file
+	std::uint64_t valuesOffset, offsetsOffset, targetsOffset, weightsOffset;
+	std::uint64_t reverseOffsetsOffset, reverseSourcesOffset, reverseWeightsOffset;
+};
+
+constexpr char binaryGraphMagic[8] = { 'A', 'S', 'T', 'G', 'R', 'A', 'P', 'H' };
+constexpr std::uint32_t binaryGraphVersion = 1;
+constexpr std::uint32_t binaryGraphByteOrderMark = 0x01020304;
+
+// Whether the file at path starts with the binary graph magic bytes
+bool isBinaryGraphFile(const std::filesystem::path& path);
+
+// Written to a temporary file which then replaces the one at path, so a graph still mapped from that file (see mapBinaryFile) is never
+// rewritten underneath it. Returns the path saved to, or nothing and sets error if the file couldn't be written or replaced
+template<class ValueType, class WeightType>
+std::optional<std::filesystem::path> saveToBinaryFile(const DirectedGraph<ValueType, WeightType>& graph, std::string path, std::string& error) {
+	static_assert(std::is_trivially_copyable_v<ValueType> && std::is_trivially_copyable_v<WeightType>, "Binary graph files store values and weights as raw bytes.");
+
+	std::filesystem::path filepath = std::filesystem::path(path).replace_extension("graph");
+	std::filesystem::path temporaryPath = filepath; temporaryPath += ".tmp";
+	std::ofstream file(temporaryPath, std::ios::binary);
+	if (!file.is_open()) { error = "Could not open " + temporaryPath.generic_string(); return std::nullopt; }
+
+	CompressedGraph<ValueType, WeightType> compressed(graph);
+	auto& arrays = compressed.arrays();
+
+	BinaryGraphHeader header{};
+	std::memcpy(header.magic, binaryGraphMagic, sizeof(header.magic));
+	header.version = binaryGraphVersion;
+	header.byteOrderMark = binaryGraphByteOrderMark;
+	header.valueSize = sizeof(ValueType); header.weightSize = sizeof(WeightType);
+	header.numNodes = arrays.numNodes; header.numEdges = arrays.numEdges;
+
+	// Lay the arrays out one after another, rounding each start up to a multiple of 8
+	std::uint64_t position = sizeof(BinaryGraphHeader);
+	auto place = [&](std::uint64_t& offset, std::uint64_t numBytes) { offset = (position + 7) & ~std::uint64_t(7); position = offset + numBytes; };
+	place(header.valuesOffset, arrays.numNodes * sizeof(ValueType));
+	place(header.offsetsOffset, (arrays.numNodes + 1) * sizeof(int));
+	place(header.targetsOffset, arrays.numEdges * sizeof(int));
+	place(header.weightsOffset, arrays.numEdges * sizeof(WeightType));
+	place(header.reverseOffsetsOffset, (arrays.numNodes + 1) * sizeof(int));
+	place(header.reverseSourcesOffset, arrays.numEdges * sizeof(int));
+	place(header.reverseWeightsOffset, arrays.numEdges * sizeof(WeightType));
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	std::uint64_t written = sizeof(header);
+	auto write = [&](std::uint64_t offset, const void* data, std::uint64_t numBytes) {
+		static const char padding[8] = {};
+		file.write(padding, offset - written);
+		file.write(static_cast<const char*>(data), numBytes);
+		written = offset + numBytes;
+	};
+	write(header.valuesOffset, arrays.values, arrays.numNodes * sizeof(ValueType));
+	write(header.offsetsOffset, arrays.offsets, (arrays.numNodes + 1) * sizeof(int));
+	write(header.targetsOffset, arrays.targets, arrays.numEdges * sizeof(int));
+	write(header.weightsOffset, arrays.weights, arrays.numEdges * sizeof(WeightType));
+	write(header.reverseOffsetsOffset, arrays.reverseOffsets, (arrays.numNodes + 1) * sizeof(int));
+	write(header.reverseSourcesOffset, arrays.reverseSources, arrays.numEdges * sizeof(int));
+	write(header.reverseWeightsOffset, arrays.reverseWeights, arrays.numEdges * sizeof(WeightType));
+
+	std::error_code ec;
+	file.close();
+	if (!file) {
+		std::filesystem::remove(temporaryPath, ec);
+		error = "Could not write " + temporaryPath.generic_string();
+		return std::nullopt;
+	}
+	// Replacing a file that's still mapped is fine on Linux, where the mapping keeps the old contents, but fails on Windows
+	std::filesystem::rename(temporaryPath, filepath, ec);
+	if (ec) {
+		error = "Could not replace " + filepath.generic_string() + ": " + ec.message();
+		std::filesystem::remove(temporaryPath, ec);
+		return std::nullopt;
+	}
+	return filepath;
+}
+
+// Map a binary graph file into memory and view it as a graph, without reading or copying the arrays. The mapping stays open for as long
+// as any copy of the returned graph exists. Returns nothing if the file can't be opened or isn't a valid graph of these types
+template<class ValueType, class WeightType>
+std::optional<CompressedGraph<ValueType, WeightType>> mapBinaryFile(const std::filesystem::path& path, unsigned long long sourceRevision = 0) {
+	auto file = std::make_shared<const MappedFile>(path);
+	if (!file->isOpen() || file->size() < sizeof(BinaryGraphHeader)) { return std::nullopt; }
+
+	BinaryGraphHeader header;
+	std::memcpy(&header, file->data(), sizeof(header));
+	if (std::memcmp(header.magic, binaryGraphMagic, sizeof(header.magic)) != 0 || header.version != binaryGraphVersion || header.byteOrderMark != binaryGraphByteOrderMark
+		|| header.valueSize != sizeof(ValueType) || header.weightSize != sizeof(WeightType)) {
+		return std::nullopt;
+	}
+
+	// Every array has to be aligned and lie inside the file
+	bool valid = header.numNodes < static_cast<std::uint64_t>(std::numeric_limits<int>::max()) && header.numEdges < static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+	auto locate = [&]<class T>(std::uint64_t offset, std::uint64_t count, const T*& out) {
+		valid = valid && offset % alignof(T) == 0 && offset <= file->size() && count <= (file->size() - offset) / sizeof(T);
+		out = valid ? reinterpret_cast<const T*>(file->data() + offset) : nullptr;
+	};
+	typename CompressedGraph<ValueType, WeightType>::Arrays arrays{};
+	arrays.numNodes = header.numNodes; arrays.numEdges = header.numEdges;
+	locate(header.valuesOffset, header.numNodes, arrays.values);
+	locate(header.offsetsOffset, header.numNodes + 1, arrays.offsets);
+	locate(header.targetsOffset, header.numEdges, arrays.targets);
+	locate(header.weightsOffset, header.numEdges, arrays.weights);
+	locate(header.reverseOffsetsOffset, header.numNodes + 1, arrays.reverseOffsets);
+	locate(header.reverseSourcesOffset, header.numEdges, arrays.reverseSources);
+	locate(header.reverseWeightsOffset, header.numEdges, arrays.reverseWeights);
+	if (!valid) { return std::nullopt; }
+
+	// Check every index is in range, so a corrupt file can't send a search outside the arrays. This only reads the file, it doesn't copy anything
+	auto validRows = [&](const int* offsets, const int* indices) {
+		if (offsets[0] != 0 || offsets[header.numNodes] != header.numEdges) { return false; }
+		for (size_t i = 0; i < header.numNodes; ++i) { if (offsets[i] > offsets[i + 1]) { return false; } }
+		for (size_t i = 0; i < header.numEdges; ++i) { if (indices[i] < 0 || indices[i] >= header.numNodes) { return false; } }
+		return true;
+	};
+	if (!validRows(arrays.offsets, arrays.targets) || !validRows(arrays.reverseOffsets, arrays.reverseSources)) { return std::nullopt; }
+
+	return CompressedGraph<ValueType, WeightType>(arrays, std::move(file), sourceRevision);
+}
+
+// Editable copy of a binary graph file, along with the graph viewing the mapped file it was copied from
+template<class ValueType, class WeightType>
+std::optional<std::pair<DirectedGraph<ValueType, WeightType>, CompressedGraph<ValueType, WeightType>>> loadFromBinaryFile(const std::filesystem::path& path) {
+	auto mapped = mapBinaryFile<ValueType, WeightType>(path);
+	if (!mapped) { return std::nullopt; }
+	DirectedGraph<ValueType, WeightType> graph = decompress(*mapped);
+	// Mark the mapped graph as an up to date copy of the new graph, so it can be used for pathfinding without building another
+	return std::make_pair(graph, CompressedGraph<ValueType, WeightType>(mapped->arrays(), mapped->backing(), graph.revision()));
+}
\ No newline at end of file
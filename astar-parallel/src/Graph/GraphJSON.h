@@ -6,6 +6,15 @@
 
 #include <fstream>
 #include <filesystem>
+#include <optional>
+#include <system_error>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <charconv>
+#include <cmath>
+#include <type_traits>
 
 using json = nlohmann::json;
 
@@ -49,13 +58,252 @@ void from_json(const json& j, DirectedGraph<ValueType, WeightType>& graph) {
 }
 
 
+// Builds a graph straight from a stream of SAX events, in the format written by to_json, rather than parsing the whole file into a json DOM first.
+// Nodes are created as they're read, with their values going through a small json so any type with from_json works. Edges are buffered
+// until the whole array has been read, since they may point at nodes later in the file, and are only added once every index in them
+// has been checked against the final node count. Indices from the file are never trusted to size anything.
 template<class ValueType, class WeightType>
-std::filesystem::path saveToFile(const DirectedGraph<ValueType, WeightType>& graph, std::string path) {
+class GraphSaxLoader : public nlohmann::json_sax<json>
+{
+public:
+	explicit GraphSaxLoader(DirectedGraph<ValueType, WeightType>& graph) : m_graph(graph) {}
+
+	// Whether the file ended cleanly and every edge was between nodes it defined
+	bool complete() const { return m_finished; }
+
+	bool null() override { return primitive(json(nullptr)); }
+	bool boolean(bool val) override { return primitive(json(val)); }
+	bool number_integer(number_integer_t val) override { return number(val); }
+	bool number_unsigned(number_unsigned_t val) override { return number(val); }
+	bool number_float(number_float_t val, const string_t&) override { return number(val); }
+	bool string(string_t& val) override { return primitive(json(val)); }
+	bool binary(binary_t& val) override { return primitive(json(val)); }
+
+	bool start_object(std::size_t) override { return startContainer(json::object()); }
+	bool start_array(std::size_t elements) override {
+		// Top level array of nodes. Only binary encodings know their element counts up front; text JSON reports -1
+		if (m_contexts.empty()) {
+			if (elements != static_cast<std::size_t>(-1)) { m_graph.reserve(elements); }
+			m_contexts.push_back(Context::Nodes);
+			return true;
+		}
+		if (m_contexts.back() == Context::Node && m_key == "edges") { m_contexts.push_back(Context::Edges); m_hasEdges = true; return true; }
+		return startContainer(json::array());
+	}
+
+	bool key(string_t& val) override { m_key = val; return true; }
+
+	bool end_object() override { return endContainer(); }
+	bool end_array() override { return endContainer(); }
+
+	bool parse_error(std::size_t, const std::string&, const json::exception&) override { return false; }
+
+private:
+	enum class Context { Nodes, Node, Edges, Edge, Value, Ignored };
+
+	DirectedGraph<ValueType, WeightType>& m_graph;
+	std::vector<Context> m_contexts;
+	std::string m_key;
+	bool m_finished = false;
+
+	// Node currently being read
+	// Every key from_json reads has to be present, as it would throw otherwise
+	int m_nodeIndex = -1; bool m_hasNodeIndex = false, m_hasEdges = false;
+	json m_value; bool m_hasValue = false;
+	std::vector<json*> m_valueStack;
+
+	// Every edge read so far. The current node's edges are at the end from m_firstNodeEdge, and get their source once its index is known
+	struct PendingEdge { int source; int index; WeightType weight; };
+	std::vector<PendingEdge> m_edges;
+	size_t m_firstNodeEdge = 0;
+	PendingEdge m_edge{ -1, -1, WeightType(0) };
+	bool m_hasEdgeIndex = false, m_hasEdgeWeight = false;
+
+	// Add a value to whichever json container is being filled in, or make it the whole value
+	json& addToValue(json&& val) {
+		if (m_valueStack.empty()) { m_value = std::move(val); return m_value; }
+		json& container = *m_valueStack.back();
+		if (container.is_object()) { return container[m_key] = std::move(val); }
+		container.push_back(std::move(val));
+		return container.back();
+	}
+
+	bool primitive(json&& val) {
+		if (m_contexts.empty()) { return false; }
+		if (m_contexts.back() == Context::Value) { addToValue(std::move(val)); }
+		else if (m_contexts.back() == Context::Node && m_key == "value") { addToValue(std::move(val)); m_hasValue = true; }
+		return true;
+	}
+
+	template<class Number>
+	bool number(Number val) {
+		if (m_contexts.empty()) { return false; }
+		Context context = m_contexts.back();
+		if (context == Context::Node && m_key == "index") { m_nodeIndex = static_cast<int>(val); m_hasNodeIndex = true; return true; }
+		if (context == Context::Edge && m_key == "index") { m_edge.index = static_cast<int>(val); m_hasEdgeIndex = true; return true; }
+		if (context == Context::Edge && m_key == "weight") { m_edge.weight = static_cast<WeightType>(val); m_hasEdgeWeight = true; return true; }
+		return primitive(json(val));
+	}
+
+	bool startContainer(json&& container) {
+		if (m_contexts.empty()) { return false; }
+		switch (m_contexts.back()) {
+		case Context::Nodes:
+			m_contexts.push_back(Context::Node);
+			m_nodeIndex = -1; m_hasNodeIndex = false; m_hasEdges = false; m_hasValue = false; m_firstNodeEdge = m_edges.size();
+			return true;
+		case Context::Edges:
+			m_contexts.push_back(Context::Edge);
+			m_edge = PendingEdge{ -1, -1, WeightType(0) };
+			m_hasEdgeIndex = false; m_hasEdgeWeight = false;
+			return true;
+		case Context::Node:
+			if (m_key != "value") { break; }
+			m_valueStack.push_back(&addToValue(std::move(container)));
+			m_contexts.push_back(Context::Value);
+			return true;
+		case Context::Value:
+			m_valueStack.push_back(&addToValue(std::move(container)));
+			m_contexts.push_back(Context::Value);
+			return true;
+		default:
+			break;
+		}
+		m_contexts.push_back(Context::Ignored);
+		return true;
+	}
+
+	bool endContainer() {
+		if (m_contexts.empty()) { return false; }
+		Context context = m_contexts.back();
+		m_contexts.pop_back();
+		switch (context) {
+		case Context::Nodes: return finishGraph();
+		case Context::Node: return finishNode();
+		case Context::Edge:
+			if (!m_hasEdgeIndex || !m_hasEdgeWeight) { return false; }
+			m_edges.push_back(m_edge);
+			return true;
+		case Context::Value:
+			m_valueStack.pop_back();
+			if (m_valueStack.empty()) { m_hasValue = true; }
+			return true;
+		default:
+			return true;
+		}
+	}
+
+	// Nodes are placed in file order, as from_json does, with edges starting from the node's own index field
+	bool finishNode() {
+		if (!m_hasValue || !m_hasNodeIndex || !m_hasEdges) { return false; }
+		m_graph.createNode(m_value.get<ValueType>());
+		for (size_t i = m_firstNodeEdge; i < m_edges.size(); ++i) { m_edges[i].source = m_nodeIndex; }
+		return true;
+	}
+
+	// Rejects the whole file if any edge starts or ends outside the nodes it defined, as from_json would have thrown on it
+	bool finishGraph() {
+		int numNodes = static_cast<int>(m_graph.size());
+		auto inRange = [numNodes](int index) { return index >= 0 && index < numNodes; };
+		for (const PendingEdge& edge : m_edges) {
+			if (!inRange(edge.source) || !inRange(edge.index)) { return false; }
+		}
+		for (const PendingEdge& edge : m_edges) { m_graph.setEdgeWeight(edge.source, edge.index, edge.weight); }
+		m_edges = std::vector<PendingEdge>();
+		m_finished = true;
+		return true;
+	}
+};
+
+
+// Append a number as JSON. Floating point values are written as the shortest text which reads back as exactly the same double
+// (as json stores every float as a double), with ".0" added to whole numbers so they still read as floats, as json::dump does.
+// That usually matches dump byte for byte, but isn't guaranteed to: where more than one shortest text reads back the same, the two can
+// pick a different last digit, and they can choose differently between fixed and exponent notation. Either reads back identically
+template<class Number>
+void appendJSONNumber(std::string& out, Number value) {
+	char buffer[64];
+	char* end;
+	if constexpr (std::is_floating_point_v<Number>) {
+		if (!std::isfinite(value)) { out += "null"; return; }
+		end = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(value)).ptr;
+		if (std::find_if(buffer, end, [](char c) { return c == '.' || c == 'e'; }) == end) { *end++ = '.'; *end++ = '0'; }
+	}
+	else { end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr; }
+	out.append(buffer, end);
+}
+
+// Write graph as JSON in the same format as to_json, one node at a time, without building a DOM of the whole graph.
+// Compact output has no whitespace at all (as json::dump gives by default); otherwise each node, edge and key goes on its own tab-indented line
+template<class ValueType, class WeightType>
+void writeJSON(std::ostream& out, const DirectedGraph<ValueType, WeightType>& graph, bool compact = true) {
+	const char* newline = compact ? "" : "\n";
+	const char* keySeparator = compact ? ":" : ": ";
+	auto indent = [compact](std::string& text, int depth) { if (!compact) { text.append(depth, '\t'); } };
+	auto key = [&](std::string& text, int depth, const char* name) { indent(text, depth); text += '"'; text += name; text += '"'; text += keySeparator; };
+
+	// Each node is built up in here then written in one go; its capacity is reused from node to node
+	std::string text;
+
+	out << '[' << newline;
+	for (int i = 0; i < graph.size(); ++i) {
+		text.clear();
+		indent(text, 1); text += '{'; text += newline;
+
+		// Keys in sorted order, as json objects store them
+		key(text, 2, "edges"); text += '[';
+		const std::map<int, WeightType>& map = graph.at(i).adjacencyMap();
+		bool firstEdge = true;
+		for (auto& [index, weight] : map) {
+			if (!firstEdge) { text += ','; }
+			firstEdge = false;
+			text += newline; indent(text, 3); text += '{'; text += newline;
+			key(text, 4, "index"); appendJSONNumber(text, index); text += ','; text += newline;
+			key(text, 4, "weight"); appendJSONNumber(text, weight); text += newline;
+			indent(text, 3); text += '}';
+		}
+		if (!map.empty()) { text += newline; indent(text, 2); }
+		text += "],"; text += newline;
+
+		key(text, 2, "index"); appendJSONNumber(text, i); text += ','; text += newline;
+		// Values can be any type with a to_json, so go through a (small) json for them
+		key(text, 2, "value"); text += json(graph.at(i).value()).dump(); text += newline;
+
+		indent(text, 1); text += '}';
+		if (i + 1 < graph.size()) { text += ','; }
+		text += newline;
+		out.write(text.data(), text.size());
+	}
+	out << ']';
+}
+
+// Written to a temporary file which then replaces the one at path, so a failed write never leaves an existing graph truncated.
+// Returns the path saved to, or nothing and sets error if the file couldn't be written or replaced
+template<class ValueType, class WeightType>
+std::optional<std::filesystem::path> saveToFile(const DirectedGraph<ValueType, WeightType>& graph, std::string path, std::string& error, bool compact = true) {
 	std::filesystem::path filepath = std::filesystem::path(path).replace_extension("json");
-	std::ofstream file(filepath);
-	if (file.is_open()) {
-		json data = graph;
-		file << data;
+	std::filesystem::path temporaryPath = filepath; temporaryPath += ".tmp";
+
+	// Larger buffer than the default, so the many small node writes reach the disk in big blocks
+	std::vector<char> buffer(1 << 20);
+	std::ofstream file;
+	file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	file.open(temporaryPath, std::ios::binary);
+	if (!file.is_open()) { error = "Could not open " + temporaryPath.generic_string(); return std::nullopt; }
+	writeJSON(file, graph, compact);
+
+	std::error_code ec;
+	file.close();
+	if (!file) {
+		std::filesystem::remove(temporaryPath, ec);
+		error = "Could not write " + temporaryPath.generic_string();
+		return std::nullopt;
+	}
+	std::filesystem::rename(temporaryPath, filepath, ec);
+	if (ec) {
+		error = "Could not replace " + filepath.generic_string() + ": " + ec.message();
+		std::filesystem::remove(temporaryPath, ec);
+		return std::nullopt;
 	}
 	return filepath;
 }
@@ -63,10 +311,16 @@ std::filesystem::path saveToFile(const DirectedGraph<ValueType, WeightType>& gra
 template<class ValueType, class WeightType>
 std::pair<DirectedGraph<ValueType, WeightType>, std::filesystem::path> loadFromFile(std::string path) {
 	std::filesystem::path filepath = std::filesystem::path(path).replace_extension("json");
-	std::ifstream file(filepath);
+	std::ifstream file(filepath, std::ios::binary);
 	if (file.is_open()) {
-		json data = json::parse(file);
-		return std::make_pair(data.get<DirectedGraph<ValueType, WeightType>>(), filepath);
+		// Streamed in one pass, so memory use is proportional to the graph rather than to a DOM of the whole file
+		DirectedGraph<ValueType, WeightType> graph;
+		GraphSaxLoader<ValueType, WeightType> loader(graph);
+		try {
+			if (json::sax_parse(file, &loader) && loader.complete()) { return std::make_pair(std::move(graph), filepath); }
+		}
+		// Values of the wrong type
+		catch (const json::exception&) {}
 	}
 	return std::make_pair(DirectedGraph<ValueType, WeightType>(), filepath);
 }
\ No newline at end of file
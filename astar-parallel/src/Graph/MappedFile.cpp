@@ -0,0 +1,52 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// The file and mapping handles aren't kept: an open view keeps the mapping alive by itself
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) { return; }
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (view) { m_data = static_cast<const std::byte*>(view); m_size = static_cast<size_t>(fileSize.QuadPart); }
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file == -1) { return; }
+	struct stat fileStat;
+	if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0) {
+		void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+		if (view != MAP_FAILED) { m_data = static_cast<const std::byte*>(view); m_size = static_cast<size_t>(fileStat.st_size); }
+	}
+	close(file);
+#endif
+}
+
+MappedFile::~MappedFile() {
+	if (!m_data) { return; }
+#ifdef _WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+}
+
+bool MappedFile::isOpen() const { return m_data != nullptr; }
+const std::byte* MappedFile::data() const { return m_data; }
+size_t MappedFile::size() const { return m_size; }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// Whole file mapped read-only into memory, so its contents can be used in place without being read or copied.
+// The mapping lasts as long as the object.
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool isOpen() const;
+	const std::byte* data() const;
+	size_t size() const;
+
+private:
+	const std::byte* m_data = nullptr;
+	size_t m_size = 0;
+};
\ No newline at end of file
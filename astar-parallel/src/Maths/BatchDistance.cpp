@@ -0,0 +1,120 @@
+#include "BatchDistance.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BATCH_DISTANCE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC allows AVX2 intrinsics anywhere, GCC and Clang only in functions marked as targeting it
+#if defined(BATCH_DISTANCE_X86) && !defined(_MSC_VER)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace {
+	void euclideanScalar(const float* xs, const float* ys, size_t begin, size_t count, Vec2 target, float* out) {
+		for (size_t i = begin; i < count; ++i) {
+			float dx = xs[i] - target.x, dy = ys[i] - target.y;
+			out[i] = std::sqrt(dx * dx + dy * dy);
+		}
+	}
+
+	void manhattanScalar(const float* xs, const float* ys, size_t begin, size_t count, Vec2 target, float* out) {
+		for (size_t i = begin; i < count; ++i) {
+			float dx = xs[i] - target.x, dy = ys[i] - target.y;
+			out[i] = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+		}
+	}
+
+#ifdef BATCH_DISTANCE_X86
+	// Whether the CPU (and OS, which has to save the wider registers) supports AVX2
+	bool supportsAVX2() {
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) { return false; }
+		__cpuid(info, 1);
+		bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		if (!osSavesYmm) { return false; }
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+	const bool hasAVX2 = supportsAVX2();
+
+	// Each returns how many points it handled, leaving the remainder (fewer than one register's worth) to the scalar loop.
+	// Loads are unaligned, since the arrays are only guaranteed the alignment of a float
+
+	TARGET_AVX2 size_t euclideanAVX2(const float* xs, const float* ys, size_t count, Vec2 target, float* out) {
+		__m256 targetX = _mm256_set1_ps(target.x), targetY = _mm256_set1_ps(target.y);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), targetX);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), targetY);
+			// Separate multiply and add rather than FMA, which would round differently from the scalar version
+			_mm256_storeu_ps(out + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))));
+		}
+		return i;
+	}
+
+	TARGET_AVX2 size_t manhattanAVX2(const float* xs, const float* ys, size_t count, Vec2 target, float* out) {
+		__m256 targetX = _mm256_set1_ps(target.x), targetY = _mm256_set1_ps(target.y);
+		// Clearing the sign bit gives the absolute value
+		__m256 signMask = _mm256_set1_ps(-0.f);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			__m256 dx = _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(xs + i), targetX));
+			__m256 dy = _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(ys + i), targetY));
+			_mm256_storeu_ps(out + i, _mm256_add_ps(dx, dy));
+		}
+		return i;
+	}
+
+	size_t euclideanSSE(const float* xs, const float* ys, size_t count, Vec2 target, float* out) {
+		__m128 targetX = _mm_set1_ps(target.x), targetY = _mm_set1_ps(target.y);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), targetX);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), targetY);
+			_mm_storeu_ps(out + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+		}
+		return i;
+	}
+
+	size_t manhattanSSE(const float* xs, const float* ys, size_t count, Vec2 target, float* out) {
+		__m128 targetX = _mm_set1_ps(target.x), targetY = _mm_set1_ps(target.y);
+		__m128 signMask = _mm_set1_ps(-0.f);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128 dx = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_loadu_ps(xs + i), targetX));
+			__m128 dy = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_loadu_ps(ys + i), targetY));
+			_mm_storeu_ps(out + i, _mm_add_ps(dx, dy));
+		}
+		return i;
+	}
+#endif
+}
+
+void euclideanDistances(const float* xs, const float* ys, size_t count, Vec2 target, float* out) {
+	size_t done = 0;
+#ifdef BATCH_DISTANCE_X86
+	done = hasAVX2 ? euclideanAVX2(xs, ys, count, target, out) : euclideanSSE(xs, ys, count, target, out);
+#endif
+	euclideanScalar(xs, ys, done, count, target, out);
+}
+
+void manhattanDistances(const float* xs, const float* ys, size_t count, Vec2 target, float* out) {
+	size_t done = 0;
+#ifdef BATCH_DISTANCE_X86
+	done = hasAVX2 ? manhattanAVX2(xs, ys, count, target, out) : manhattanSSE(xs, ys, count, target, out);
+#endif
+	manhattanScalar(xs, ys, done, count, target, out);
+}
\ No newline at end of file
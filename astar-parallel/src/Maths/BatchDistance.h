@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Vec2.h"
+#include <cstddef>
+
+// Distances from each of count points, given as separate x and y arrays, to a single target, written to out.
+// Vectorised with AVX2 or SSE2 depending on what the CPU supports (checked once at runtime), with a scalar fallback for the
+// remainder and for other architectures. Every path does the same IEEE operations in the same order, so the results are
+// bit-identical to euclideanDistance and manhattanDistance whichever one runs.
+void euclideanDistances(const float* xs, const float* ys, size_t count, Vec2 target, float* out);
+void manhattanDistances(const float* xs, const float* ys, size_t count, Vec2 target, float* out);
\ No newline at end of file
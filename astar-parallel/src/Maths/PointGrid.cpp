@@ -0,0 +1,85 @@
+#include "PointGrid.h"
+
+#include <cmath>
+#include <queue>
+#include <algorithm>
+#include <limits>
+
+PointGrid::PointGrid(const std::vector<Vec2>& points) : m_points(points), m_min(0.f, 0.f), m_cellSize(1.f, 1.f), m_cellsX(1), m_cellsY(1) {
+	if (points.empty()) { m_cellOffsets.assign(2, 0); return; }
+
+	Vec2 max = points.front(); m_min = points.front();
+	for (const Vec2& point : points) {
+		m_min.x = std::min(m_min.x, point.x); m_min.y = std::min(m_min.y, point.y);
+		max.x = std::max(max.x, point.x); max.y = std::max(max.y, point.y);
+	}
+
+	// Roughly two points per cell, assuming they're spread fairly evenly
+	int cellsPerAxis = std::max(1, static_cast<int>(std::ceil(std::sqrt(points.size() / 2.0))));
+	m_cellsX = m_cellsY = cellsPerAxis;
+	// Avoid zero-sized cells when every point shares an x or y coordinate
+	m_cellSize.x = std::max((max.x - m_min.x) / m_cellsX, std::numeric_limits<float>::min());
+	m_cellSize.y = std::max((max.y - m_min.y) / m_cellsY, std::numeric_limits<float>::min());
+
+	// Counting sort of point indices by cell
+	std::vector<int> cellOfPoint(points.size());
+	m_cellOffsets.assign(m_cellsX * m_cellsY + 1, 0);
+	for (int i = 0; i < points.size(); ++i) {
+		cellOfPoint[i] = cellY(points[i].y) * m_cellsX + cellX(points[i].x);
+		++m_cellOffsets[cellOfPoint[i] + 1];
+	}
+	for (int cell = 0; cell < m_cellsX * m_cellsY; ++cell) { m_cellOffsets[cell + 1] += m_cellOffsets[cell]; }
+
+	m_sortedPoints.resize(points.size());
+	std::vector<int> next(m_cellOffsets.begin(), m_cellOffsets.end() - 1);
+	for (int i = 0; i < points.size(); ++i) { m_sortedPoints[next[cellOfPoint[i]]++] = i; }
+}
+
+int PointGrid::cellX(float x) const { return std::clamp(static_cast<int>((x - m_min.x) / m_cellSize.x), 0, m_cellsX - 1); }
+int PointGrid::cellY(float y) const { return std::clamp(static_cast<int>((y - m_min.y) / m_cellSize.y), 0, m_cellsY - 1); }
+
+void PointGrid::kNearest(int index, int k, const DistanceFunction<Vec2, float>& distanceFunc, std::vector<int>& out) const {
+	out.clear();
+	if (k <= 0) { return; }
+
+	const Vec2& root = m_points[index];
+	int rootX = cellX(root.x), rootY = cellY(root.y);
+
+	// Bounded max-heap of the best candidates so far, so the top is the one to evict when a closer point turns up
+	struct Candidate { float distance; int index; };
+	auto closer = [](const Candidate& lhs, const Candidate& rhs) { return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.index < rhs.index); };
+	std::priority_queue<Candidate, std::vector<Candidate>, decltype(closer)> best(closer);
+
+	auto visitCell = [&](int x, int y) {
+		if (x < 0 || x >= m_cellsX || y < 0 || y >= m_cellsY) { return; }
+		int cell = y * m_cellsX + x;
+		for (int i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i) {
+			int other = m_sortedPoints[i];
+			if (other == index) { continue; }
+			Candidate candidate{ distanceFunc(root, m_points[other]), other };
+			if (best.size() < k) { best.push(candidate); }
+			else if (closer(candidate, best.top())) { best.pop(); best.push(candidate); }
+		}
+	};
+
+	int maxRing = std::max({ rootX, m_cellsX - 1 - rootX, rootY, m_cellsY - 1 - rootY });
+	for (int ring = 0; ring <= maxRing; ++ring) {
+		// Cells exactly ring steps away from the root's cell, going round the edge of the square
+		if (ring == 0) { visitCell(rootX, rootY); }
+		else {
+			for (int x = rootX - ring; x <= rootX + ring; ++x) { visitCell(x, rootY - ring); visitCell(x, rootY + ring); }
+			for (int y = rootY - ring + 1; y <= rootY + ring - 1; ++y) { visitCell(rootX - ring, y); visitCell(rootX + ring, y); }
+		}
+
+		// Every point outside the square searched so far is at least as far away as its nearest edge, so once the worst candidate beats that we're done
+		if (best.size() == k) {
+			float edgeDistance = std::min({
+				root.x - (m_min.x + (rootX - ring) * m_cellSize.x), (m_min.x + (rootX + ring + 1) * m_cellSize.x) - root.x,
+				root.y - (m_min.y + (rootY - ring) * m_cellSize.y), (m_min.y + (rootY + ring + 1) * m_cellSize.y) - root.y });
+			if (best.top().distance < edgeDistance) { break; }
+		}
+	}
+
+	out.resize(best.size());
+	for (int i = static_cast<int>(best.size()) - 1; i >= 0; --i) { out[i] = best.top().index; best.pop(); }
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Vec2.h"
+#include "../Pathfinding/Prototypes.h"
+#include <vector>
+
+// Uniform grid of buckets over a fixed set of points, for finding each point's nearest neighbours without comparing against every other point.
+// Buckets are sized to hold a couple of points each on average, and are stored in CSR form (point indices sorted by bucket plus an offset per bucket).
+class PointGrid
+{
+public:
+	PointGrid(const std::vector<Vec2>& points);
+
+	// Fill out with the indices of the k points nearest to the point at index (excluding itself), nearest first, ties going to the lower index.
+	// Searches outwards ring by ring, so distanceFunc must never be less than the larger of the x and y differences (true of Euclidean and Manhattan distance)
+	void kNearest(int index, int k, const DistanceFunction<Vec2, float>& distanceFunc, std::vector<int>& out) const;
+
+private:
+	const std::vector<Vec2>& m_points;
+	Vec2 m_min, m_cellSize;
+	int m_cellsX, m_cellsY;
+
+	std::vector<int> m_cellOffsets;
+	std::vector<int> m_sortedPoints;
+
+	int cellX(float x) const;
+	int cellY(float y) const;
+};
\ No newline at end of file
@@ -1,43 +1,52 @@
 #pragma once
 
 #include "../Graph/DirectedGraph.h"
+#include "../Graph/CompressedGraph.h"
 
 #include <functional>
-#include <queue>
 #include <algorithm>
 #include <limits>
 #include "Prototypes.h"
+#include "SearchContext.h"
+#include "OpenSet.h"
+
+// Graph can be any type exposing size(), value(index) and adjacency(index) which the heuristic also accepts, ie. CompressedGraph.
+// The g, f and parent values live in the passed SearchContext, which is reset lazily so repeated queries only pay for the nodes they touch.
+// OpenSet picks the priority queue policy (see OpenSet.h); RadixHeapOpenSet is faster but expects a consistent heuristic.
+// HeuristicFunc is deduced from the argument, so passing a functor such as DistanceHeuristic<EuclideanDistance> lets the heuristic be
+// inlined into the loop, while a Heuristic (std::function) works with anything. The other algorithms take their heuristic the same way.
+template<class Graph, template<class> class OpenSet = IndexedHeapOpenSet, class HeuristicFunc = Heuristic<typename Graph::value_type, typename Graph::weight_type>>
+Path aStarSequential(const Graph& graph, int start, int goal, const HeuristicFunc& heuristicFunc, SearchContext<typename Graph::weight_type>& context) {
+	using Weight = typename Graph::weight_type;
 
-template<class Value, class Weight>
-Path aStarSequential(const DirectedGraph<Value,Weight>& graph, int start, int goal, const Heuristic<Value,Weight>& heuristicFunc) {
 	if (graph.size() == 0) { return Path(); }
 
-	// Shorthand for calling heuristic at a given index
-	auto h = [&](int index) { return heuristicFunc(graph.at(index).value(), graph.at(goal).value()); };
-
-	// Vectors initialised to the same size as the graph so they can be easily indexed
-	std::vector<Weight> costFromStart, estimatedTotalCost;
-	std::vector<int> parentIndex;
-	costFromStart.reserve(graph.size()); estimatedTotalCost.reserve(graph.size()); parentIndex.reserve(graph.size());
-	for (int i = 0; i < graph.size(); ++i) {
-		// Init g and f values to max value so new values will always be less
-		costFromStart.push_back(std::numeric_limits<Weight>::max());
-		estimatedTotalCost.push_back(std::numeric_limits<Weight>::max());
-		parentIndex.push_back(-1);
-	}
+	// Shorthand for the heuristic at a given index, evaluated at most once per node however many times its cost is lowered
+	auto evaluate = [&](int index) { return heuristicFunc(graph, index, goal); };
+	auto h = [&](int index) { return context.heuristic(index, evaluate); };
+
+	// Invalidates the g, f and h values from any previous query, so g and f all read as max value and new values will always be less
+	context.beginQuery(graph.size());
+
 	// Set weight at start index to zero
-	costFromStart[start] = 0; estimatedTotalCost[start] = h(start);
+	context.set(start, 0, h(start), -1);
 
-	// Open set is represented by a priority queue ordered by lowest f score of index
-	auto greaterEstimatedCost = [&estimatedTotalCost](const int& lhs, const int& rhs) { return estimatedTotalCost.at(lhs) > estimatedTotalCost.at(rhs); };
-	std::priority_queue<int, std::vector<int>, decltype(greaterEstimatedCost)> openSet(greaterEstimatedCost);
+	// Open set holds (f, index) entries, lowest f first
+	auto& openSet = context.template openSet<OpenSet<Weight>>();
+
+	// Instrumentation, which compiles to nothing unless enabled (see SearchStats.h)
+	context.stats().reset(1);
+	ThreadSearchStats& stats = context.stats().thread(0);
 
 	// Push start index
-	openSet.push(start);
+	openSet.push(context.estimatedTotalCost(start), start);
 
 	while (!openSet.empty()) {
-		// Node in the open set with lowest f score
-		int current = openSet.top();
+		// Remove node in the open set with lowest f score
+		auto [estimatedTotalCost, current] = openSet.pop();
+
+		// Stale entry, superseded by one with a lower f pushed since (only for open sets which don't decrease keys in place)
+		if (estimatedTotalCost > context.estimatedTotalCost(current)) { continue; }
 
 		// Goal found
 		if (current == goal) {
@@ -45,7 +54,7 @@ Path aStarSequential(const DirectedGraph<Value,Weight>& graph, int start, int go
 			Path path; path.push_back(current);
 			int prev = current;
 			while (prev != start) {
-				prev = parentIndex.at(prev);
+				prev = context.parentIndex(prev);
 				path.push_back(prev);
 			}
 			// Reverse so that it runs from start to goal
@@ -53,24 +62,23 @@ Path aStarSequential(const DirectedGraph<Value,Weight>& graph, int start, int go
 			return path;
 		}
 
-		// Remove current from open set
-		openSet.pop();
+		// Closed flags are only kept to spot re-expansions, which happen when the heuristic is inconsistent
+		if constexpr (searchStatsEnabled) { stats.expanded(context.closed(current)); context.close(current); }
 
 		// For each neighbour of current
-		const std::map<int, Weight>& adjacencyMap = graph.at(current).adjacencyMap();
-
-		for (auto& [neighbour, edgeWeight] : adjacencyMap) {
-			Weight tentativeNeighbourCost = costFromStart.at(current) + edgeWeight;
-
-			if (tentativeNeighbourCost < costFromStart.at(neighbour)) {
-				parentIndex[neighbour] = current;
-
-				// Update cost
-				costFromStart[neighbour] = tentativeNeighbourCost;
-				estimatedTotalCost[neighbour] = tentativeNeighbourCost + h(neighbour);
-
-				// Push neighbour to open set
-				openSet.push(neighbour);
+		Weight costCurrent = context.costFromStart(current);
+		for (auto [neighbour, edgeWeight] : graph.adjacency(current)) {
+			Weight tentativeNeighbourCost = costCurrent + edgeWeight;
+
+			if (tentativeNeighbourCost < context.costFromStart(neighbour)) {
+				// Update cost and parent
+				Weight estimatedNeighbourCost = tentativeNeighbourCost + h(neighbour);
+				context.set(neighbour, tentativeNeighbourCost, estimatedNeighbourCost, current);
+
+				// Push neighbour to open set, or lower its f if already there
+				openSet.push(estimatedNeighbourCost, neighbour);
+				stats.relaxed();
+				stats.openSetSize(openSet.size());
 			}
 		}
 	}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <type_traits>
+
+// Lock-free table of (cost, parent) pairs, one per node, for sharing g values between threads.
+// Each pair is packed into a single 64-bit atomic so the two can never be observed out of step,
+// and is only ever lowered (via compare-and-swap), never raised.
+// Slots are grouped into cache-line-sized, cache-line-aligned blocks so no slot straddles two lines.
+// Reads and successful writes are sequentially consistent, so that two threads each lowering a value in one table then reading
+// the same index in another can't both miss the other's write (this costs nothing extra on x86, where the CAS is a full fence anyway).
+template<class Weight>
+class AtomicCostTable
+{
+	static_assert(sizeof(Weight) == sizeof(std::uint32_t) && std::is_trivially_copyable_v<Weight>, "AtomicCostTable packs weights into 32 bits.");
+
+public:
+	AtomicCostTable(size_t size) : m_lines((size + slotsPerLine - 1) / slotsPerLine) {
+		std::uint64_t empty = pack(std::numeric_limits<Weight>::max(), -1);
+		for (auto& line : m_lines) { for (auto& slot : line.slots) { slot.store(empty, std::memory_order_relaxed); } }
+	}
+
+	Weight cost(int index) const { return unpackCost(slot(index).load()); }
+	int parent(int index) const { return unpackParent(slot(index).load()); }
+
+	// Set cost and parent at index if cost is lower than the current value. Returns whether it was lowered
+	bool tryLower(int index, Weight cost, int parent) {
+		auto& target = slot(index);
+		std::uint64_t current = target.load(std::memory_order_relaxed);
+		std::uint64_t desired = pack(cost, parent);
+		while (cost < unpackCost(current)) {
+			// On failure current is refreshed with whatever another thread wrote, and we retry only if we still beat it
+			if (target.compare_exchange_weak(current, desired, std::memory_order_seq_cst, std::memory_order_relaxed)) { return true; }
+		}
+		return false;
+	}
+
+private:
+	static constexpr size_t cacheLineSize = 64;
+	static constexpr size_t slotsPerLine = cacheLineSize / sizeof(std::uint64_t);
+
+	struct alignas(cacheLineSize) Line { std::atomic<std::uint64_t> slots[slotsPerLine]; };
+	std::vector<Line> m_lines;
+
+	std::atomic<std::uint64_t>& slot(int index) { return m_lines[index / slotsPerLine].slots[index % slotsPerLine]; }
+	const std::atomic<std::uint64_t>& slot(int index) const { return m_lines[index / slotsPerLine].slots[index % slotsPerLine]; }
+
+	static std::uint64_t pack(Weight cost, int parent) {
+		return (static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(cost)) << 32) | static_cast<std::uint32_t>(parent);
+	}
+	static Weight unpackCost(std::uint64_t packed) { return std::bit_cast<Weight>(static_cast<std::uint32_t>(packed >> 32)); }
+	static int unpackParent(std::uint64_t packed) { return static_cast<int>(static_cast<std::uint32_t>(packed)); }
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../Graph/CompressedGraph.h"
+
+#include <queue>
+#include <algorithm>
+#include <limits>
+#include "Prototypes.h"
+#include "SearchContext.h"
+
+// New Bidirectional A* (Pijls & Post, 2009).
+// A forward search from start and a backward search from goal (over incoming edges) take turns expanding, sharing the best
+// path length found where they meet and a set M of nodes which neither side needs to look at again. A node is only expanded
+// if both the f score on its own side and the bound from the other side's lowest f score say it could still improve on the best path,
+// and the search stops as soon as either side runs out of nodes, at which point the best path found is optimal.
+// Graph must provide reverseAdjacency(index) as well as the usual interface, ie. CompressedGraph.
+template<class Graph, class HeuristicFunc = Heuristic<typename Graph::value_type, typename Graph::weight_type>>
+Path bidirectionalAStar(const Graph& graph, int start, int goal, const HeuristicFunc& heuristicFunc, SearchContext<typename Graph::weight_type>& context) {
+	using Weight = typename Graph::weight_type;
+	const Weight maxWeight = std::numeric_limits<Weight>::max();
+
+	if (graph.size() == 0) { return Path(); }
+	if (start == goal) { return Path{ start }; }
+
+	SearchContext<Weight>& forward = context;
+	SearchContext<Weight>& backward = context.reverse();
+	forward.beginQuery(graph.size()); backward.beginQuery(graph.size());
+
+	// Each side estimates the distance to where the other side started from. Both are asked for the same nodes repeatedly (once
+	// per improvement, and again by the other side when pruning), so are cached in that side's context for the rest of the query
+	auto evaluateForward = [&](int index) { return heuristicFunc(graph, index, goal); };
+	auto evaluateBackward = [&](int index) { return heuristicFunc(graph, start, index); };
+	auto hForward = [&](int index) { return forward.heuristic(index, evaluateForward); };
+	auto hBackward = [&](int index) { return backward.heuristic(index, evaluateBackward); };
+
+	// M is shared by both sides, so is kept as the forward context's closed flags
+	auto inM = [&](int index) { return forward.closed(index); };
+
+	// Open set entries carry a snapshot of the g value they were pushed with. Entries for nodes whose g has since been lowered
+	// (or which have joined M) are skipped when they reach the top
+	struct OpenSetEntry { Weight estimatedTotalCost, costFromStart; int index; };
+	struct GreaterEstimatedCost { bool operator()(const OpenSetEntry& lhs, const OpenSetEntry& rhs) const { return lhs.estimatedTotalCost > rhs.estimatedTotalCost; } };
+	using open_set = std::priority_queue<OpenSetEntry, std::vector<OpenSetEntry>, GreaterEstimatedCost>;
+
+	open_set forwardOpenSet, backwardOpenSet;
+	forward.set(start, 0, hForward(start), -1); forwardOpenSet.push(OpenSetEntry{ hForward(start), 0, start });
+	backward.set(goal, 0, hBackward(goal), -1); backwardOpenSet.push(OpenSetEntry{ hBackward(goal), 0, goal });
+
+	// Lowest f score in each open set
+	Weight forwardLowestCost = hForward(start), backwardLowestCost = hBackward(goal);
+
+	// Length of best path found so far and the node the two sides met at
+	Weight bestCost = maxWeight;
+	int meetingNode = -1;
+
+	while (!forwardOpenSet.empty() && !backwardOpenSet.empty()) {
+		// Expand whichever side has the smaller open set
+		bool isForward = forwardOpenSet.size() <= backwardOpenSet.size();
+		open_set& openSet = isForward ? forwardOpenSet : backwardOpenSet;
+		SearchContext<Weight>& side = isForward ? forward : backward;
+		SearchContext<Weight>& otherSide = isForward ? backward : forward;
+		Weight otherLowestCost = isForward ? backwardLowestCost : forwardLowestCost;
+
+		OpenSetEntry entry = openSet.top();
+		openSet.pop();
+		int current = entry.index;
+
+		if (!inM(current) && entry.costFromStart <= side.costFromStart(current)) {
+			forward.close(current);
+
+			Weight otherH = isForward ? hBackward(current) : hForward(current);
+			bool couldImprove = entry.estimatedTotalCost < bestCost && entry.costFromStart + otherLowestCost - otherH < bestCost;
+
+			if (couldImprove) {
+				auto expand = [&](const auto& edges) {
+					for (auto [neighbour, edgeWeight] : edges) {
+						if (inM(neighbour)) { continue; }
+
+						Weight tentativeNeighbourCost = entry.costFromStart + edgeWeight;
+						if (tentativeNeighbourCost < side.costFromStart(neighbour)) {
+							Weight h = isForward ? hForward(neighbour) : hBackward(neighbour);
+							side.set(neighbour, tentativeNeighbourCost, tentativeNeighbourCost + h, current);
+							openSet.push(OpenSetEntry{ tentativeNeighbourCost + h, tentativeNeighbourCost, neighbour });
+
+							// Reached by both sides, so there is a path through here
+							Weight otherCost = otherSide.costFromStart(neighbour);
+							if (otherCost != maxWeight && tentativeNeighbourCost + otherCost < bestCost) {
+								bestCost = tentativeNeighbourCost + otherCost;
+								meetingNode = neighbour;
+							}
+						}
+					}
+				};
+				if (isForward) { expand(graph.adjacency(current)); } else { expand(graph.reverseAdjacency(current)); }
+			}
+		}
+
+		// Clear out stale entries so the top gives this side's lowest f score
+		while (!openSet.empty() && (inM(openSet.top().index) || openSet.top().costFromStart > side.costFromStart(openSet.top().index))) { openSet.pop(); }
+		if (!openSet.empty()) { (isForward ? forwardLowestCost : backwardLowestCost) = openSet.top().estimatedTotalCost; }
+	}
+
+	// Fail state
+	if (meetingNode == -1) { return Path(); }
+
+	// Forward half runs from the meeting node back to start, so is reversed
+	Path path;
+	for (int index = meetingNode; index != -1; index = forward.parentIndex(index)) { path.push_back(index); }
+	std::reverse(path.begin(), path.end());
+	// Backward parents already point towards the goal
+	for (int index = backward.parentIndex(meetingNode); index != -1; index = backward.parentIndex(index)) { path.push_back(index); }
+	return path;
+}
\ No newline at end of file
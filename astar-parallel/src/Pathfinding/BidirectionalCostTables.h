@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+// Per-node state shared between the two threads of parallel bidirectional A*: a (g, parent) table for each side and the flags for M.
+// Kept in a SearchContext so it carries over between queries. Every slot and flag is stamped with the generation of the query which
+// last wrote it, so beginQuery only has to bump the generation, and anything with an older stamp reads back as untouched.
+// Unlike AtomicCostTable, each side's table must only ever be written by one thread: claiming a slot left over from an older query
+// writes the pair and then the stamp, which two writers could interleave.
+template<class Weight>
+class BidirectionalCostTables
+{
+	static_assert(sizeof(Weight) == sizeof(std::uint32_t) && std::is_trivially_copyable_v<Weight>, "BidirectionalCostTables packs weights into 32 bits.");
+
+public:
+	// One side's table, written by that side's thread and read by both. Everything is sequentially consistent, so that each side
+	// lowering a value in its own table then reading the same index in the other's can't both miss the other's write
+	class Side
+	{
+	public:
+		Weight cost(int index) const {
+			const Slot& slot = m_slots[index];
+			return slot.generation.load() == m_generation ? unpackCost(slot.packed.load()) : std::numeric_limits<Weight>::max();
+		}
+		int parent(int index) const {
+			const Slot& slot = m_slots[index];
+			return slot.generation.load() == m_generation ? unpackParent(slot.packed.load()) : -1;
+		}
+
+		// Set cost and parent at index if cost is lower than the current value. Returns whether it was lowered
+		bool tryLower(int index, Weight cost, int parent) {
+			Slot& slot = m_slots[index];
+			// The pair is stored before the stamp, so anyone who sees the new stamp also sees the new pair
+			if (slot.generation.load(std::memory_order_relaxed) != m_generation) {
+				slot.packed.store(pack(cost, parent));
+				slot.generation.store(m_generation);
+				return true;
+			}
+			// Only we write here, so no compare-and-swap is needed
+			if (cost < unpackCost(slot.packed.load(std::memory_order_relaxed))) { slot.packed.store(pack(cost, parent)); return true; }
+			return false;
+		}
+
+	private:
+		friend class BidirectionalCostTables;
+
+		// 16 bytes and 16 byte aligned, so no slot straddles two cache lines
+		struct alignas(16) Slot { std::atomic<std::uint64_t> packed; std::atomic<std::uint32_t> generation; };
+		std::unique_ptr<Slot[]> m_slots;
+		std::uint32_t m_generation = 0;
+
+		static std::uint64_t pack(Weight cost, int parent) {
+			return (static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(cost)) << 32) | static_cast<std::uint32_t>(parent);
+		}
+		static Weight unpackCost(std::uint64_t packed) { return std::bit_cast<Weight>(static_cast<std::uint32_t>(packed >> 32)); }
+		static int unpackParent(std::uint64_t packed) { return static_cast<int>(static_cast<std::uint32_t>(packed)); }
+	};
+
+	// Prepare for a new query over a graph with the given number of nodes. Must not be called while a search is using the tables
+	void beginQuery(size_t graphSize) {
+		if (m_size < graphSize) {
+			// Value initialised, so every stamp starts at 0, which is never a valid generation
+			m_forward.m_slots = std::make_unique<typename Side::Slot[]>(graphSize);
+			m_backward.m_slots = std::make_unique<typename Side::Slot[]>(graphSize);
+			m_inM = std::make_unique<std::atomic<std::uint32_t>[]>(graphSize);
+			m_size = graphSize;
+			m_generation = 0;
+		}
+		// Stamps would become ambiguous once the counter wraps, so do a full reset in that (very rare) case
+		if (++m_generation == 0) {
+			for (size_t i = 0; i < m_size; ++i) {
+				m_forward.m_slots[i].generation.store(0, std::memory_order_relaxed);
+				m_backward.m_slots[i].generation.store(0, std::memory_order_relaxed);
+				m_inM[i].store(0, std::memory_order_relaxed);
+			}
+			m_generation = 1;
+		}
+		m_forward.m_generation = m_generation; m_backward.m_generation = m_generation;
+	}
+
+	Side& forward() { return m_forward; }
+	Side& backward() { return m_backward; }
+
+	// Nodes which neither side needs to look at again. Either side may add to M
+	bool inM(int index) const { return m_inM[index].load() == m_generation; }
+	void addToM(int index) { m_inM[index].store(m_generation); }
+
+private:
+	Side m_forward, m_backward;
+	std::unique_ptr<std::atomic<std::uint32_t>[]> m_inM;
+	size_t m_size = 0;
+	std::uint32_t m_generation = 0;
+};
\ No newline at end of file
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include "Prototypes.h"
+#include "SearchContext.h"
+
+#include "../Threading/ThreadPool.h"
+
+// Contraction hierarchy (Geisberger et al., 2008), for answering many queries on a graph which doesn't change.
+// Preprocessing removes ("contracts") nodes one at a time in order of importance, adding a shortcut edge between two of the
+// removed node's neighbours wherever the path through it was the only shortest one. The node order is a ranking, and any shortest
+// path can then be found using only edges going up the ranking from each end, so queries touch a tiny part of the graph.
+//
+// Nodes are ordered by edge difference (shortcuts added minus edges removed) plus the number of neighbours already contracted, which
+// keeps contraction spread evenly. Each round contracts every node whose priority is lower than all of its neighbours', so the
+// contracted nodes are an independent set and their witness searches can all run in parallel on the thread pool.
+template<class Weight>
+class ContractionHierarchy
+{
+public:
+	ContractionHierarchy() = default;
+
+	// Graph must provide reverseAdjacency(index) as well as the usual interface, ie. CompressedGraph
+	template<class Graph>
+	ContractionHierarchy(const Graph& graph, int numThreads) : m_rank(graph.size(), -1) {
+		size_t numNodes = graph.size();
+		numThreads = std::max(numThreads, 1);
+
+		// Remaining graph, which shortcuts are added to and contracted nodes removed from as contraction goes on
+		BuildState state;
+		state.out.resize(numNodes); state.in.resize(numNodes);
+		state.contracted.assign(numNodes, false);
+		for (int i = 0; i < numNodes; ++i) {
+			for (auto [neighbour, edgeWeight] : graph.adjacency(i)) {
+				if (neighbour == i) { continue; }
+				state.out[i].push_back(Arc{ neighbour, edgeWeight, -1 });
+				state.in[neighbour].push_back(Arc{ i, edgeWeight, -1 });
+			}
+		}
+
+		// Edges recorded for each node at the time it was contracted, all of which lead to nodes ranked above it
+		std::vector<std::vector<Arc>> upward(numNodes), downward(numNodes);
+
+		// Each thread gets its own context for witness searches
+		std::vector<SearchContext<Weight>> contexts(numThreads);
+		std::vector<int> priority(numNodes, 0), deletedNeighbours(numNodes, 0);
+		std::vector<char> needsUpdate(numNodes, true);
+
+		// Run func(node, context) for every node in nodes, spread across the thread pool
+		auto parallelForEach = [&](const std::vector<int>& nodes, auto func) {
+			std::atomic<size_t> next = 0;
+			auto threadFunc = [&](int threadIndex) {
+				std::vector<Shortcut> scratch;
+				for (size_t i = next++; i < nodes.size(); i = next++) { func(i, contexts[threadIndex], scratch); }
+			};
+			ThreadPool::shared().run(std::min<int>(numThreads, static_cast<int>(std::max<size_t>(nodes.size(), 1))), threadFunc);
+		};
+
+		std::vector<int> remaining(numNodes);
+		for (int i = 0; i < numNodes; ++i) { remaining[i] = i; }
+		std::vector<int> toUpdate, independentSet;
+		std::vector<std::vector<Shortcut>> shortcuts;
+		int nextRank = 0;
+
+		while (!remaining.empty()) {
+			// Recalculate priorities of any node whose neighbourhood changed last round
+			toUpdate.clear();
+			for (int node : remaining) { if (needsUpdate[node]) { toUpdate.push_back(node); needsUpdate[node] = false; } }
+			parallelForEach(toUpdate, [&](size_t i, SearchContext<Weight>& context, std::vector<Shortcut>& scratch) {
+				int node = toUpdate[i];
+				findShortcuts(state, node, context, scratch);
+				int edgeDifference = static_cast<int>(scratch.size()) - static_cast<int>(state.in[node].size() + state.out[node].size());
+				priority[node] = edgeDifference + deletedNeighbours[node];
+			});
+
+			// Nodes which come before all of their neighbours, ties broken by index
+			auto before = [&](int lhs, int rhs) { return priority[lhs] < priority[rhs] || (priority[lhs] == priority[rhs] && lhs < rhs); };
+			independentSet.clear();
+			for (int node : remaining) {
+				auto beforeArc = [&](const Arc& arc) { return before(node, arc.node); };
+				if (std::all_of(state.in[node].begin(), state.in[node].end(), beforeArc) && std::all_of(state.out[node].begin(), state.out[node].end(), beforeArc)) {
+					independentSet.push_back(node);
+				}
+			}
+
+			// Witness searches must avoid every node being contracted this round, not just their own, or two nodes could each
+			// skip a shortcut on the strength of a witness path through the other
+			for (int node : independentSet) { state.contracted[node] = true; }
+			shortcuts.resize(independentSet.size());
+			parallelForEach(independentSet, [&](size_t i, SearchContext<Weight>& context, std::vector<Shortcut>&) {
+				findShortcuts(state, independentSet[i], context, shortcuts[i]);
+			});
+
+			// Apply results in a fixed order so the hierarchy doesn't depend on thread timing
+			for (size_t i = 0; i < independentSet.size(); ++i) {
+				int node = independentSet[i];
+				m_rank[node] = nextRank++;
+				upward[node] = std::move(state.out[node]); downward[node] = std::move(state.in[node]);
+				state.out[node].clear(); state.in[node].clear();
+
+				// Only counted when a new arc is added, not when one already there is lowered or is already shorter.
+				// The in lists mirror the out lists, so the two always agree on which that was
+				for (const Shortcut& shortcut : shortcuts[i]) {
+					if (insertOrLower(state.out[shortcut.from], Arc{ shortcut.to, shortcut.weight, node })) { ++m_numShortcuts; }
+					insertOrLower(state.in[shortcut.to], Arc{ shortcut.from, shortcut.weight, node });
+				}
+
+				// Remove edges into the contracted node from the remaining graph
+				auto removeArcs = [&](const std::vector<Arc>& arcs, std::vector<std::vector<Arc>>& adjacency) {
+					for (const Arc& arc : arcs) {
+						auto& list = adjacency[arc.node];
+						list.erase(std::remove_if(list.begin(), list.end(), [&](const Arc& other) { return other.node == node; }), list.end());
+						++deletedNeighbours[arc.node];
+						needsUpdate[arc.node] = true;
+					}
+				};
+				removeArcs(upward[node], state.in);
+				removeArcs(downward[node], state.out);
+			}
+
+			remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](int node) { return state.contracted[node]; }), remaining.end());
+		}
+
+		// Flatten into CSR form
+		auto compress = [numNodes](const std::vector<std::vector<Arc>>& lists, std::vector<int>& offsets, std::vector<Arc>& arcs) {
+			offsets.assign(numNodes + 1, 0);
+			for (int i = 0; i < numNodes; ++i) { offsets[i + 1] = offsets[i] + static_cast<int>(lists[i].size()); }
+			arcs.clear(); arcs.reserve(offsets.back());
+			for (auto& list : lists) { arcs.insert(arcs.end(), list.begin(), list.end()); }
+		};
+		compress(upward, m_upwardOffsets, m_upwardArcs);
+		compress(downward, m_downwardOffsets, m_downwardArcs);
+	}
+
+	// Shortest path from start to goal, found by a bidirectional Dijkstra search which only ever moves up the hierarchy.
+	// Forward and backward state live in context and context.reverse()
+	Path query(int start, int goal, SearchContext<Weight>& context) const {
+		const Weight maxWeight = std::numeric_limits<Weight>::max();
+
+		if (numNodes() == 0) { return Path(); }
+		if (start == goal) { return Path{ start }; }
+
+		SearchContext<Weight>& forward = context;
+		SearchContext<Weight>& backward = context.reverse();
+		forward.beginQuery(numNodes()); backward.beginQuery(numNodes());
+
+		struct OpenSetEntry { Weight costFromStart; int index; };
+		struct GreaterCost { bool operator()(const OpenSetEntry& lhs, const OpenSetEntry& rhs) const { return lhs.costFromStart > rhs.costFromStart; } };
+		using open_set = std::priority_queue<OpenSetEntry, std::vector<OpenSetEntry>, GreaterCost>;
+
+		open_set forwardOpenSet, backwardOpenSet;
+		forward.set(start, 0, 0, -1); forwardOpenSet.push(OpenSetEntry{ 0, start });
+		backward.set(goal, 0, 0, -1); backwardOpenSet.push(OpenSetEntry{ 0, goal });
+
+		Weight bestCost = maxWeight;
+		int meetingNode = -1;
+
+		while (true) {
+			Weight forwardLowest = forwardOpenSet.empty() ? maxWeight : forwardOpenSet.top().costFromStart;
+			Weight backwardLowest = backwardOpenSet.empty() ? maxWeight : backwardOpenSet.top().costFromStart;
+			// Neither side can find anything shorter
+			if (std::min(forwardLowest, backwardLowest) >= bestCost) { break; }
+
+			bool isForward = forwardLowest <= backwardLowest;
+			open_set& openSet = isForward ? forwardOpenSet : backwardOpenSet;
+			SearchContext<Weight>& side = isForward ? forward : backward;
+			const SearchContext<Weight>& otherSide = isForward ? backward : forward;
+
+			OpenSetEntry entry = openSet.top();
+			openSet.pop();
+			int current = entry.index;
+			if (side.closed(current) || entry.costFromStart > side.costFromStart(current)) { continue; }
+			side.close(current);
+
+			// Reached by both sides, so there is a path through here
+			Weight otherCost = otherSide.costFromStart(current);
+			if (otherCost != maxWeight && entry.costFromStart + otherCost < bestCost) {
+				bestCost = entry.costFromStart + otherCost;
+				meetingNode = current;
+			}
+
+			for (const Arc& arc : isForward ? upwardArcs(current) : downwardArcs(current)) {
+				Weight tentativeCost = entry.costFromStart + arc.weight;
+				if (tentativeCost < side.costFromStart(arc.node)) {
+					side.set(arc.node, tentativeCost, tentativeCost, current);
+					openSet.push(OpenSetEntry{ tentativeCost, arc.node });
+				}
+			}
+		}
+
+		// Fail state
+		if (meetingNode == -1) { return Path(); }
+
+		// Chains of hierarchy edges from start up to the meeting node, and from the meeting node down to goal
+		Path forwardChain, backwardChain;
+		for (int index = meetingNode; index != -1; index = forward.parentIndex(index)) { forwardChain.push_back(index); }
+		std::reverse(forwardChain.begin(), forwardChain.end());
+		for (int index = meetingNode; index != -1; index = backward.parentIndex(index)) { backwardChain.push_back(index); }
+
+		// Unpack every shortcut along the way back into the edges it stands for. Any arc missing along the way means the hierarchy
+		// is broken, which fails the query rather than reading past the arcs
+		Path path{ start };
+		for (size_t i = 0; i + 1 < forwardChain.size(); ++i) {
+			const Arc* arc = findArc(upwardArcs(forwardChain[i]), forwardChain[i + 1]);
+			if (!arc || !unpack(forwardChain[i], forwardChain[i + 1], arc->middle, path)) { return Path(); }
+		}
+		for (size_t i = 0; i + 1 < backwardChain.size(); ++i) {
+			const Arc* arc = findArc(downwardArcs(backwardChain[i + 1]), backwardChain[i]);
+			if (!arc || !unpack(backwardChain[i], backwardChain[i + 1], arc->middle, path)) { return Path(); }
+		}
+		return path;
+	}
+
+	size_t numNodes() const { return m_rank.size(); }
+	size_t numShortcuts() const { return m_numShortcuts; }
+	int rank(int index) const { return m_rank[index]; }
+
+private:
+	// Edge in the hierarchy. Middle is the node a shortcut bypasses, or -1 for an edge of the original graph
+	struct Arc { int node; Weight weight; int middle; };
+	struct Shortcut { int from, to; Weight weight; };
+
+	struct BuildState {
+		std::vector<std::vector<Arc>> out, in;
+		std::vector<char> contracted;
+	};
+
+	// Witness searches give up after settling this many nodes. Stopping early only ever means adding a shortcut which wasn't needed
+	static constexpr int witnessSettleLimit = 500;
+
+	std::vector<int> m_rank;
+	size_t m_numShortcuts = 0;
+
+	// Outgoing edges of each node to nodes ranked above it, and incoming edges from nodes ranked above it
+	std::vector<int> m_upwardOffsets, m_downwardOffsets;
+	std::vector<Arc> m_upwardArcs, m_downwardArcs;
+
+	struct ArcRange {
+		const Arc* first; const Arc* last;
+		const Arc* begin() const { return first; }
+		const Arc* end() const { return last; }
+	};
+	ArcRange upwardArcs(int index) const { return ArcRange{ m_upwardArcs.data() + m_upwardOffsets[index], m_upwardArcs.data() + m_upwardOffsets[index + 1] }; }
+	ArcRange downwardArcs(int index) const { return ArcRange{ m_downwardArcs.data() + m_downwardOffsets[index], m_downwardArcs.data() + m_downwardOffsets[index + 1] }; }
+
+	// Arc in arcs leading to node, or null if there isn't one
+	static const Arc* findArc(ArcRange arcs, int node) {
+		const Arc* arc = std::find_if(arcs.begin(), arcs.end(), [node](const Arc& arc) { return arc.node == node; });
+		return arc != arcs.end() ? arc : nullptr;
+	}
+
+	// Append the nodes after from on the original path from -> to which an edge with the given middle node stands for.
+	// Returns false if an arc the hierarchy should contain is missing
+	bool unpack(int from, int to, int middle, Path& path) const {
+		if (middle == -1) { path.push_back(to); return true; }
+		// Both halves were edges of the middle node when it was contracted, so are stored with it
+		const Arc* first = findArc(downwardArcs(middle), from);
+		const Arc* second = findArc(upwardArcs(middle), to);
+		return first && second && unpack(from, middle, first->middle, path) && unpack(middle, to, second->middle, path);
+	}
+
+	// Add arc to list, or lower the existing arc to the same node if the new one is shorter. Returns whether it was added
+	static bool insertOrLower(std::vector<Arc>& list, const Arc& arc) {
+		auto existing = std::find_if(list.begin(), list.end(), [&](const Arc& other) { return other.node == arc.node; });
+		if (existing == list.end()) { list.push_back(arc); return true; }
+		if (arc.weight < existing->weight) { *existing = arc; }
+		return false;
+	}
+
+	// Fill shortcuts with the shortcuts that contracting node would need: one for every pair of neighbours (a, b) where a -> node -> b
+	// is shorter than any witness path from a to b found avoiding node and every contracted node
+	static void findShortcuts(const BuildState& state, int node, SearchContext<Weight>& context, std::vector<Shortcut>& shortcuts) {
+		shortcuts.clear();
+		if (state.in[node].empty() || state.out[node].empty()) { return; }
+
+		Weight maxOutWeight = 0;
+		for (const Arc& out : state.out[node]) { maxOutWeight = std::max(maxOutWeight, out.weight); }
+
+		for (const Arc& in : state.in[node]) {
+			witnessSearch(state, in.node, node, in.weight + maxOutWeight, context);
+			for (const Arc& out : state.out[node]) {
+				if (out.node == in.node) { continue; }
+				Weight viaNode = in.weight + out.weight;
+				if (context.costFromStart(out.node) > viaNode) { shortcuts.push_back(Shortcut{ in.node, out.node, viaNode }); }
+			}
+		}
+	}
+
+	// Dijkstra from source through the remaining graph without passing through excluded, stopping once past maxCost.
+	// Leaves distances in context, where any node not reached reads as max value
+	static void witnessSearch(const BuildState& state, int source, int excluded, Weight maxCost, SearchContext<Weight>& context) {
+		context.beginQuery(state.out.size());
+
+		struct OpenSetEntry { Weight costFromStart; int index; };
+		struct GreaterCost { bool operator()(const OpenSetEntry& lhs, const OpenSetEntry& rhs) const { return lhs.costFromStart > rhs.costFromStart; } };
+		std::priority_queue<OpenSetEntry, std::vector<OpenSetEntry>, GreaterCost> openSet;
+
+		context.set(source, 0, 0, -1);
+		openSet.push(OpenSetEntry{ 0, source });
+
+		int numSettled = 0;
+		while (!openSet.empty() && numSettled < witnessSettleLimit) {
+			OpenSetEntry entry = openSet.top();
+			openSet.pop();
+			if (entry.costFromStart > maxCost) { break; }
+			if (entry.costFromStart > context.costFromStart(entry.index)) { continue; }
+			++numSettled;
+
+			for (const Arc& arc : state.out[entry.index]) {
+				if (arc.node == excluded || state.contracted[arc.node]) { continue; }
+				Weight tentativeCost = entry.costFromStart + arc.weight;
+				if (tentativeCost < context.costFromStart(arc.node)) {
+					context.set(arc.node, tentativeCost, tentativeCost, entry.index);
+					openSet.push(OpenSetEntry{ tentativeCost, arc.node });
+				}
+			}
+		}
+	}
+};
\ No newline at end of file
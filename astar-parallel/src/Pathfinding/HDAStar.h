@@ -1,22 +1,31 @@
 #pragma once
 
 #include "../Graph/DirectedGraph.h"
+#include "../Graph/CompressedGraph.h"
 
 #include <functional>
-#include <queue>
-#include <set>
+#include <mutex>
 #include <algorithm>
 #include <thread>
-#include <barrier>
 #include <limits>
 #include "Prototypes.h"
 
-#include "MutexProtectedWrapper.h"
+#include "../Threading/ThreadPool.h"
+#include "AtomicCostTable.h"
+#include "ParallelTermination.h"
+#include "OpenSet.h"
+#include "HeuristicCache.h"
+#include "Heuristics.h"
+#include "SearchStats.h"
 
 static int g_numThreads = std::thread::hardware_concurrency();
 
-template<class Value, class Weight>
-Path hashDistributedAStarSharedMemory(const DirectedGraph<Value, Weight>& graph, int start, int goal, const Heuristic<Value, Weight>& heuristicFunc) {
+// Graph can be any type exposing size(), value(index) and adjacency(index) which the heuristic also accepts, ie. CompressedGraph.
+// Only the SearchContext's heuristic cache and stats are used, which the worker threads share; g values and parents live in their own table.
+template<class Graph, class HeuristicFunc = Heuristic<typename Graph::value_type, typename Graph::weight_type>>
+Path hashDistributedAStarSharedMemory(const Graph& graph, int start, int goal, const HeuristicFunc& heuristicFunc, SearchContext<typename Graph::weight_type>& context) {
+	using Weight = typename Graph::weight_type;
+
 	if (graph.size() == 0) { return Path(); }
 
 	// Find number of threads we will be using
@@ -26,111 +35,135 @@ Path hashDistributedAStarSharedMemory(const DirectedGraph<Value, Weight>& graph,
 	// Hash function to assign indicies to threads
 	auto hash = [numThreads](int index) { return index % numThreads; };
 
-	// Vectors of mutex-protected values. Protected is just a simple wrapper class for accessing the values thread-safely
-	std::vector<Protected<Weight>> costFromStart;
-	std::vector<Protected<int>> parentIndex;
-	// The h values don't change (we're just caching them), so they don't need thread protection
-	std::vector<Weight> h; 
-	costFromStart.reserve(graph.size()); parentIndex.reserve(graph.size()); h.reserve(graph.size());
-	for (int i = 0; i < graph.size(); ++i) {
-		costFromStart.emplace_back(std::numeric_limits<Weight>::max());
-		parentIndex.emplace_back(-1);
-		h.push_back(heuristicFunc(graph.at(i).value(), graph.at(goal).value()));
+	// Lock-free table of (g, parent) pairs, which any thread can lower with a compare-and-swap
+	AtomicCostTable<Weight> costTable(graph.size());
+	// h values are filled in as nodes are first reached, so nodes the search never touches are never evaluated, unless the cache
+	// is set to prefill them all up front
+	HeuristicCache<Weight>& heuristicCache = context.heuristicCache();
+	heuristicCache.beginQuery(graph.size());
+	auto evaluate = [&](int index) { return heuristicFunc(graph, index, goal); };
+	if (heuristicCache.prefill()) {
+		heuristicCache.fill([&](int first, int count, Weight* out) { evaluateHeuristicRange(graph, heuristicFunc, first, count, goal, out); });
 	}
+	auto h = [&](int index) { return heuristicCache.get(index, evaluate); };
 
-	// f score to be used in open set ordering
-	auto estimatedTotalCost = [&costFromStart, &h](int index) { return costFromStart.at(index).get() + h.at(index); };
+	// Hash function only ever sends a thread nodes congruent to its own index, so each thread's open set is indexed by node / numThreads
+	auto localIndex = [numThreads](int index) { return index / numThreads; };
+	int localTableSize = (static_cast<int>(graph.size()) + numThreads - 1) / numThreads;
 
-	// Open sets are represented by a set ordered by lowest f score, protected by a mutex
-	auto greaterEstimatedCost = [&estimatedTotalCost](const int& lhs, const int& rhs) { return estimatedTotalCost(lhs) > estimatedTotalCost(rhs); };
-	using open_set = std::set<int, decltype(greaterEstimatedCost)>;
+	// Instrumentation, which compiles to nothing unless enabled (see SearchStats.h)
+	SearchStats& stats = context.stats();
+	stats.reset(numThreads);
 
+	// Open sets are represented by an indexed heap ordered by lowest f score, protected by a mutex.
+	// Each node has at most one entry, whose f is lowered in place when a cheaper route is found, so no memory is allocated
+	// per push once the heap has grown and no superseded entries are left behind to be popped and thrown away
 	class ProtectedOpenSet
 	{
 	private:
-		open_set m_set;
-		std::reference_wrapper<std::vector<Protected<Weight>>> m_costFromStartRef;
+		IndexedHeapOpenSet<Weight> m_set;
 		std::mutex m_mutex;
+		int m_threadIndex, m_numThreads;
+		size_t m_peakSize = 0;
 	public:
-		ProtectedOpenSet(open_set&& rhsSet, std::reference_wrapper<std::vector<Protected<Weight>>>&& costRef) : m_set(std::move(rhsSet)), m_costFromStartRef(costRef), m_mutex(std::mutex()) {}
-		ProtectedOpenSet(const ProtectedOpenSet& other) : m_set(other.m_set), m_costFromStartRef(other.m_costFromStartRef), m_mutex(std::mutex()) {}
-
-		// Pop top value from set and return it
-		int pop() {
-			auto lock = std::lock_guard(m_mutex);
-			auto top = m_set.begin(); int index = *top;
-			m_set.erase(top);
-			return index;
+		ProtectedOpenSet(int threadIndex, int numThreads) : m_threadIndex(threadIndex), m_numThreads(numThreads) {}
+		ProtectedOpenSet(const ProtectedOpenSet& other) : m_set(other.m_set), m_mutex(), m_threadIndex(other.m_threadIndex), m_numThreads(other.m_numThreads) {}
+
+		// Discard every entry in the set if the lowest f score is no lower than bound, adding the number discarded to numPruned,
+		// otherwise pop the node with the lowest f score into out. Returns false if the set was left empty.
+		// Time waiting on the lock goes to the stats of the thread calling
+		bool tryPopBelow(Weight bound, int& out, long long& numPruned, ThreadSearchStats& stats) {
+			auto lock = stats.lock(m_mutex);
+			// Everything else in the heap is at least as high as the top, so can't beat bound either
+			if (!m_set.empty() && m_set.top().estimatedTotalCost >= bound) { numPruned += m_set.size(); m_set.clear(); }
+			if (m_set.empty()) { return false; }
+			out = m_set.pop().index * m_numThreads + m_threadIndex;
+			return true;
 		}
 
-		bool isEmpty() { auto lock = std::lock_guard(m_mutex); return m_set.empty(); }
-
-		// Set cost at index then push index to open set
-		void setCostAndPush(int index, Weight newCost) {
-			// Have to erase index before setting cost, since the set's ordering is dependent on cost
-			// so it could otherwise break strict weak ordering and crash when an index was traversed more than once.
-			// (This is why this version uses a std::set instead of a std::priority_queue, which can only pop from the top) 
-
-			auto lock = std::lock_guard(m_mutex);
-			m_set.erase(index);
-			m_costFromStartRef.get().at(index).set(newCost);
-			m_set.insert(index);
+		// Returns whether a new entry was added, rather than an existing one lowered
+		bool push(Weight estimatedTotalCost, int localIndex, ThreadSearchStats& stats) {
+			auto lock = stats.lock(m_mutex);
+			bool added = m_set.push(estimatedTotalCost, localIndex);
+			if constexpr (searchStatsEnabled) { m_peakSize = std::max(m_peakSize, m_set.size()); }
+			return added;
 		}
+
+		// Largest the set has been, only recorded with stats enabled
+		size_t peakSize() const { return m_peakSize; }
 	};
 
 	// Vector of open sets, one per thread
 	std::vector<ProtectedOpenSet> openSets;
 	openSets.reserve(numThreads);
-	for (int i = 0; i < numThreads; ++i) { openSets.emplace_back(open_set(greaterEstimatedCost), std::ref(costFromStart)); }
-
-	// Set start cost to zero, push start index
-	openSets[hash(start)].setCostAndPush(start, 0);
-
-	// Barrier which threads arrive at when they run out of tasks
-	bool allWorkComplete = false;
-	std::barrier ranOutOfWorkBarrier(numThreads,
-		[&]() noexcept {
-			for (int i = 0; i < numThreads; ++i) {
-				// Some threads still have work to do
-				if (!openSets[i].isEmpty()) { return; }
-			}
-			// All threads have finished
-			allWorkComplete = true;
-		});
+	for (int i = 0; i < numThreads; ++i) { openSets.emplace_back(i, numThreads); }
+
+	// Best path cost to the goal found so far, used to prune nodes which can't improve on it
+	Incumbent<Weight> incumbent;
+	// Counts open set entries plus entries currently being expanded, so threads can stop as soon as none are left
+	TerminationDetector termination;
+
+	// Set start cost to zero, push start index. The incumbent only drops when a neighbour relaxes into the goal, so a start which is
+	// already the goal sets it here instead, and start is pruned as soon as it's popped rather than the whole graph being searched
+	costTable.tryLower(start, 0, -1);
+	if (start == goal) { incumbent.tryLower(0); }
+	termination.addWork();
+	openSets[hash(start)].push(h(start), localIndex(start), stats.thread(hash(start)));
 
 	auto threadFunc = [&](int threadIndex) {
 		auto& openSet = openSets.at(threadIndex);
-		do {
-			while (!openSet.isEmpty()) {
-				// Top of our open set
-				int current = openSet.pop();
-
-				Weight costCurrent = costFromStart[current].get();
-				const std::map<int, Weight>& adjacencyMap = graph.at(current).adjacencyMap();
+		ThreadSearchStats& threadStats = stats.thread(threadIndex);
+		// Nodes this thread has expanded by local index, only kept to spot re-expansions
+		std::vector<bool> expanded(searchStatsEnabled ? localTableSize : 0);
+		int current;
+		// Entries we've finished with but not yet removed from the termination count.
+		// Handing them back late can only delay termination, so we save on atomics by doing it once we run out of work
+		long long numFinished = 0;
+		while (true) {
+			// Top of our open set, pruning anything which can't beat the incumbent
+			if (openSet.tryPopBelow(incumbent.get(), current, numFinished, threadStats)) {
+				// Latest g, which may already be lower than the one current was pushed with
+				Weight costCurrent = costTable.cost(current);
+				++numFinished;
+				threadStats.endIdle();
+				if constexpr (searchStatsEnabled) { threadStats.expanded(expanded[localIndex(current)]); expanded[localIndex(current)] = true; }
 
 				// For each neighbour of current
-				for (auto& [neighbour, edgeWeight] : adjacencyMap) {
+				for (auto [neighbour, edgeWeight] : graph.adjacency(current)) {
 					Weight tentativeNeighbourCost = costCurrent + edgeWeight;
-					
-					if (tentativeNeighbourCost < costFromStart[neighbour].get()) {
-						parentIndex[neighbour].set(current);
 
-						// Set neighbour's cost to new value, then push to relevant open set
-						openSets[hash(neighbour)].setCostAndPush(neighbour, tentativeNeighbourCost);
+					// Set neighbour's cost and parent if lower than its current cost
+					if (costTable.tryLower(neighbour, tentativeNeighbourCost, current)) {
+						threadStats.relaxed();
+						// Reaching the goal gives a new incumbent. The goal itself never needs expanding
+						if (neighbour == goal) { incumbent.tryLower(tentativeNeighbourCost); continue; }
+
+						// Push to relevant open set, unless it already can't beat the incumbent
+						Weight neighbourEstimatedTotalCost = tentativeNeighbourCost + h(neighbour);
+						if (neighbourEstimatedTotalCost < incumbent.get()) {
+							// Counted before the push makes it visible. If it only lowered an existing entry, that entry is
+							// still counted, so the extra can be taken straight back off
+							termination.addWork();
+							if (!openSets[hash(neighbour)].push(neighbourEstimatedTotalCost, localIndex(neighbour), threadStats)) { termination.removeWork(); }
+						}
 					}
 				}
 			}
-			ranOutOfWorkBarrier.arrive_and_wait();
-		} while (!allWorkComplete);
+			else {
+				// Out of work, so hand back what we've finished then wait for more to be pushed to us or for everyone to run out
+				threadStats.beginIdle();
+				if (numFinished > 0) { termination.removeWork(numFinished); numFinished = 0; }
+				if (termination.isTerminated()) { threadStats.endIdle(); break; }
+				std::this_thread::yield();
+			}
+		}
 	};
 
-	// Create worker threads
-	std::vector<std::thread> threads;
-	threads.reserve(numThreads);
-	for (int i = 0; i < numThreads; ++i) { threads.emplace_back(threadFunc, i); }
-
-	// Wait for all worker threads to complete
-	for (auto& thread : threads) { thread.join(); }
+	// Run on the shared pool's worker threads, blocking until they have all completed
+	ThreadPool::shared().run(numThreads, threadFunc);
+	if constexpr (searchStatsEnabled) {
+		for (int i = 0; i < numThreads; ++i) { stats.thread(i).openSetSize(openSets[i].peakSize()); }
+	}
 
 	// Reconstruct path from goal back to start
 	Path path; path.push_back(goal);
@@ -139,7 +172,7 @@ Path hashDistributedAStarSharedMemory(const DirectedGraph<Value, Weight>& graph,
 	while (prev != start) {
 		// Fail state
 		if (prev == -1 || numPassed > graph.size()) { return Path(); }
-		prev = parentIndex.at(prev).get();
+		prev = costTable.parent(prev);
 		path.push_back(prev);
 		++numPassed;
 	}
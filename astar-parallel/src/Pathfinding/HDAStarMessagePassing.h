@@ -0,0 +1,194 @@
+#pragma once
+
+#include "../Graph/DirectedGraph.h"
+#include "../Graph/CompressedGraph.h"
+
+#include <algorithm>
+#include <thread>
+#include <limits>
+#include "Prototypes.h"
+
+#include "../Threading/ThreadPool.h"
+#include "HDAStar.h"
+#include "Mailbox.h"
+#include "ParallelTermination.h"
+#include "OpenSet.h"
+#include "HeuristicCache.h"
+#include "Heuristics.h"
+#include "SearchStats.h"
+
+// HDA* in its original form: every node is owned by the thread it hashes to, and no per-node state is shared.
+// Instead of touching another thread's open set, generated nodes are sent to their owner as (node, g, parent) messages,
+// which the owner receives in batches and checks against its own table of best known costs before adding to its open set.
+// Only the SearchContext's heuristic cache and stats are used. Each node's h is only ever computed by its owner, so the cache is
+// never written to by two threads at once.
+template<class Graph, class HeuristicFunc = Heuristic<typename Graph::value_type, typename Graph::weight_type>>
+Path hashDistributedAStarMessagePassing(const Graph& graph, int start, int goal, const HeuristicFunc& heuristicFunc, SearchContext<typename Graph::weight_type>& context) {
+	using Weight = typename Graph::weight_type;
+
+	if (graph.size() == 0) { return Path(); }
+
+	// Find number of threads we will be using
+	int numThreads;
+	if (g_numThreads > 0) { numThreads = g_numThreads; } else { numThreads = std::thread::hardware_concurrency(); }
+
+	// Hash function to assign indicies to threads, and the index of a node within its owner's local table
+	auto hash = [numThreads](int index) { return index % numThreads; };
+	auto localIndex = [numThreads](int index) { return index / numThreads; };
+	int localTableSize = (static_cast<int>(graph.size()) + numThreads - 1) / numThreads;
+
+	// Number of nodes to expand between checking the mailbox, and number of messages to buffer before posting them
+	const int expansionsPerReceive = 32;
+	const size_t messagesPerBatch = 64;
+
+	struct Message { int index; Weight costFromStart; int parentIndex; };
+
+	// Everything a thread owns. Only the mailbox is ever accessed by other threads
+	struct ThreadState
+	{
+		Mailbox<Message> mailbox;
+		// Best known g and parent of each owned node, doubling as the closed list for duplicate detection
+		std::vector<Weight> costFromStart;
+		std::vector<int> parentIndex;
+		// Owned nodes by local index, at most one entry each with its f lowered in place when a cheaper route is received
+		IndexedHeapOpenSet<Weight> openSet;
+		// Messages waiting to be posted, one buffer per destination thread
+		std::vector<std::vector<Message>> outboxes;
+		// Owned nodes which have been expanded, only kept to spot re-expansions
+		std::vector<bool> expanded;
+	};
+
+	std::vector<ThreadState> threadStates(numThreads);
+	for (auto& state : threadStates) {
+		state.costFromStart.assign(localTableSize, std::numeric_limits<Weight>::max());
+		state.parentIndex.assign(localTableSize, -1);
+		state.outboxes.resize(numThreads);
+		if constexpr (searchStatsEnabled) { state.expanded.assign(localTableSize, false); }
+	}
+
+	// h values are filled in the first time a node is received (or all up front, if the cache is set to prefill), so each is computed
+	// at most once however often its g is lowered
+	HeuristicCache<Weight>& heuristicCache = context.heuristicCache();
+	heuristicCache.beginQuery(graph.size());
+	auto evaluate = [&](int index) { return heuristicFunc(graph, index, goal); };
+	if (heuristicCache.prefill()) {
+		heuristicCache.fill([&](int first, int count, Weight* out) { evaluateHeuristicRange(graph, heuristicFunc, first, count, goal, out); });
+	}
+
+	// Instrumentation, which compiles to nothing unless enabled (see SearchStats.h). There are no locks to wait on
+	SearchStats& stats = context.stats();
+	stats.reset(numThreads);
+
+	// Best path cost to the goal found so far, used to prune nodes which can't improve on it
+	Incumbent<Weight> incumbent;
+	// Counts active threads plus messages in flight. Every thread starts active, and a sender adds its messages to the count
+	// before posting them, so it can only reach zero once every thread is idle with nothing left to receive
+	TerminationDetector termination(numThreads);
+
+	// Accept a message if it improves on the owner's best known cost, otherwise it's a duplicate and is dropped
+	auto receive = [&](ThreadState& state, const Message& message) {
+		int local = localIndex(message.index);
+		if (message.costFromStart < state.costFromStart[local]) {
+			state.costFromStart[local] = message.costFromStart;
+			state.parentIndex[local] = message.parentIndex;
+			// Always received by the owner, or before the threads start
+			stats.thread(hash(message.index)).relaxed();
+
+			// Reaching the goal gives a new incumbent. The goal itself never needs expanding
+			if (message.index == goal) { incumbent.tryLower(message.costFromStart); return; }
+
+			// Add to open set, unless it already can't beat the incumbent
+			Weight h = heuristicCache.get(message.index, evaluate);
+			Weight estimatedTotalCost = message.costFromStart + h;
+			if (estimatedTotalCost < incumbent.get()) {
+				state.openSet.push(estimatedTotalCost, local);
+				stats.thread(hash(message.index)).openSetSize(state.openSet.size());
+			}
+		}
+	};
+
+	// Send start to its owner
+	receive(threadStates[hash(start)], Message{ start, 0, -1 });
+
+	auto threadFunc = [&](int threadIndex) {
+		ThreadState& state = threadStates[threadIndex];
+		ThreadSearchStats& threadStats = stats.thread(threadIndex);
+		bool active = true;
+
+		auto post = [&](int owner) {
+			auto& outbox = state.outboxes[owner];
+			termination.addWork(outbox.size());
+			threadStates[owner].mailbox.post(std::move(outbox));
+			outbox = std::vector<Message>();
+		};
+
+		while (true) {
+			size_t numReceived = state.mailbox.drain([&](const Message& message) { receive(state, message); });
+			if (numReceived > 0) {
+				// Become active before taking the received messages off the count, so it can't touch zero in between
+				if (!active) { termination.addWork(); active = true; }
+				termination.removeWork(numReceived);
+			}
+
+			if (state.openSet.empty()) {
+				// Out of work, so go idle then wait for more messages or for everyone to run out
+				threadStats.beginIdle();
+				if (active) { termination.removeWork(); active = false; }
+				if (termination.isTerminated()) { threadStats.endIdle(); break; }
+				std::this_thread::yield();
+				continue;
+			}
+			threadStats.endIdle();
+
+			for (int expansion = 0; expansion < expansionsPerReceive && !state.openSet.empty(); ++expansion) {
+				// Nothing in our open set can beat the incumbent, since it's ordered by f score
+				if (state.openSet.top().estimatedTotalCost >= incumbent.get()) { state.openSet.clear(); break; }
+
+				// Top of our open set. Its key always matches our table, since a cheaper route lowers it in place
+				int local = state.openSet.pop().index;
+				int current = local * numThreads + threadIndex;
+				Weight costCurrent = state.costFromStart[local];
+				if constexpr (searchStatsEnabled) { threadStats.expanded(state.expanded[local]); state.expanded[local] = true; }
+
+				// For each neighbour of current
+				for (auto [neighbour, edgeWeight] : graph.adjacency(current)) {
+					Message message{ neighbour, costCurrent + edgeWeight, current };
+					// g alone already being too high means f will be too, so don't bother sending
+					if (message.costFromStart >= incumbent.get()) { continue; }
+					int owner = hash(neighbour);
+
+					// Nodes we own can be handled directly, otherwise buffer a message to the owner
+					if (owner == threadIndex) { receive(state, message); }
+					else {
+						state.outboxes[owner].push_back(message);
+						if (state.outboxes[owner].size() >= messagesPerBatch) { post(owner); }
+					}
+				}
+			}
+			// Don't let other threads sit idle waiting on messages we're holding onto
+			for (int i = 0; i < numThreads; ++i) {
+				if (!state.outboxes[i].empty()) { post(i); }
+			}
+		}
+	};
+
+	// Run on the shared pool's worker threads, blocking until they have all completed
+	ThreadPool::shared().run(numThreads, threadFunc);
+
+	// Reconstruct path from goal back to start, looking each parent up in the table of the thread which owns it
+	auto parentOf = [&](int index) { return threadStates[hash(index)].parentIndex[localIndex(index)]; };
+
+	Path path; path.push_back(goal);
+	int prev = goal;
+	int numPassed = 0;
+	while (prev != start) {
+		// Fail state
+		if (prev == -1 || numPassed > graph.size()) { return Path(); }
+		prev = parentOf(prev);
+		path.push_back(prev);
+		++numPassed;
+	}
+	// Reverse so that it runs from start to goal
+	std::reverse(path.begin(), path.end());
+	return path;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Heuristic values for a single query, filled in lazily the first time each node asks for one, so the heuristic is evaluated
+// at most once per node per query and never for nodes the search doesn't touch.
+// Each slot packs the value with the generation of the query that wrote it into one 64-bit atomic, so beginQuery only has to bump
+// the generation, and several threads can share the cache without locks: two threads missing on the same node both compute it,
+// but the heuristic is deterministic so whichever store lands last writes the same value anyway.
+// Searches can instead be told to prefill every slot in blocks, which lets batch heuristics (see evaluateHeuristicRange) run
+// their vector kernels over the whole graph; that beats a miss per node when a query is expected to touch most of it.
+template<class Weight>
+class HeuristicCache
+{
+	static_assert(sizeof(Weight) == sizeof(std::uint32_t) && std::is_trivially_copyable_v<Weight>, "HeuristicCache packs weights into 32 bits.");
+
+public:
+	// Whether searches should call fill at the start of each query rather than leaving every value to its first get
+	void setPrefill(bool prefill) { m_prefill = prefill; }
+	bool prefill() const { return m_prefill; }
+
+	// Prepare for a new query (with a new goal) over a graph with the given number of nodes
+	void beginQuery(size_t graphSize) {
+		if (m_size < graphSize) {
+			m_slots = std::make_unique<std::atomic<std::uint64_t>[]>(graphSize);
+			m_size = graphSize;
+			for (size_t i = 0; i < m_size; ++i) { m_slots[i].store(0, std::memory_order_relaxed); }
+			m_generation = 0;
+		}
+		// Stamps would become ambiguous once the counter wraps, so do a full reset in that (very rare) case
+		if (++m_generation == 0) {
+			for (size_t i = 0; i < m_size; ++i) { m_slots[i].store(0, std::memory_order_relaxed); }
+			m_generation = 1;
+		}
+		m_querySize = graphSize;
+	}
+
+	// Fill in every node of this query's graph, calling evaluate(first, count, out) to write the heuristic for count nodes from
+	// first. Goes a block at a time, so the values only pass through a small buffer on their way into the slots.
+	// Call after beginQuery and before any search threads start using the cache
+	template<class EvaluateRange>
+	void fill(EvaluateRange&& evaluate) {
+		constexpr int blockSize = 1024;
+		Weight block[blockSize];
+		std::uint64_t stamp = static_cast<std::uint64_t>(m_generation) << 32;
+		for (size_t first = 0; first < m_querySize; first += blockSize) {
+			int count = static_cast<int>(std::min<size_t>(blockSize, m_querySize - first));
+			evaluate(static_cast<int>(first), count, block);
+			for (int i = 0; i < count; ++i) { m_slots[first + i].store(stamp | std::bit_cast<std::uint32_t>(block[i]), std::memory_order_relaxed); }
+		}
+	}
+
+	// Heuristic at index, calling compute(index) to fill it in if this query hasn't asked for it yet.
+	// Relaxed ordering is enough, since the value travels in the same atomic as the stamp saying it's valid
+	template<class Compute>
+	Weight get(int index, Compute&& compute) {
+		std::uint64_t slot = m_slots[index].load(std::memory_order_relaxed);
+		if (static_cast<std::uint32_t>(slot >> 32) == m_generation) { return std::bit_cast<Weight>(static_cast<std::uint32_t>(slot)); }
+
+		Weight value = compute(index);
+		m_slots[index].store((static_cast<std::uint64_t>(m_generation) << 32) | std::bit_cast<std::uint32_t>(value), std::memory_order_relaxed);
+		return value;
+	}
+
+private:
+	std::unique_ptr<std::atomic<std::uint64_t>[]> m_slots;
+	size_t m_size = 0, m_querySize = 0;
+	std::uint32_t m_generation = 0;
+	bool m_prefill = false;
+};
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "Heuristics.h"
 
-float euclideanDistance(const Vec2& v1, const Vec2& v2) { return (v1 - v2).length(); }
+float euclideanDistance(const Vec2& v1, const Vec2& v2) { return EuclideanDistance()(v1, v2); }
 
-float manhattanDistance(const Vec2& v1, const Vec2& v2) { return abs(v1.x - v2.x) + abs(v1.y - v2.y); }
\ No newline at end of file
+float manhattanDistance(const Vec2& v1, const Vec2& v2) { return ManhattanDistance()(v1, v2); }
\ No newline at end of file
@@ -1,8 +1,59 @@
 #pragma once
 
 #include "../Maths/Vec2.h"
+#include "../Maths/BatchDistance.h"
 
 #include "Prototypes.h"
 
+#include <cmath>
+
 float euclideanDistance(const Vec2&, const Vec2&);
 float manhattanDistance(const Vec2&, const Vec2&);
+
+// The same distances as function objects, whose calls (unlike those through a function pointer or std::function) can be inlined
+// into a search templated on their type. Stateless, so a default constructed one is all a search needs
+struct EuclideanDistance {
+	float operator()(const Vec2& v1, const Vec2& v2) const { float dx = v1.x - v2.x, dy = v1.y - v2.y; return std::sqrt(dx * dx + dy * dy); }
+	// Distance from many points to one target at once, see BatchDistance.h
+	static void batch(const float* xs, const float* ys, size_t count, Vec2 target, float* out) { euclideanDistances(xs, ys, count, target, out); }
+};
+
+struct ManhattanDistance {
+	// Written out rather than using std::abs, which isn't constexpr until C++23
+	constexpr float operator()(const Vec2& v1, const Vec2& v2) const { float dx = v1.x - v2.x, dy = v1.y - v2.y; return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy); }
+	static void batch(const float* xs, const float* ys, size_t count, Vec2 target, float* out) { manhattanDistances(xs, ys, count, target, out); }
+};
+
+// Heuristic measuring the distance between the values of the two nodes with a distance functor, for the search algorithms'
+// HeuristicFunc template parameter. Works with any graph exposing value(index)
+template<class Distance>
+struct DistanceHeuristic {
+	Distance distance;
+
+	template<class Graph>
+	constexpr auto operator()(const Graph& graph, int from, int to) const { return distance(graph.value(from), graph.value(to)); }
+
+	// Heuristic from each of count nodes starting at first to one goal, written to out. Runs the distance's batch kernel over the
+	// graph's coordinate arrays where it has them, otherwise goes node by node
+	template<class Graph, class Weight>
+	void evaluateRange(const Graph& graph, int first, int count, int to, Weight* out) const {
+		if constexpr (requires { requires Graph::hasCoordinates; Distance::batch(graph.xs(), graph.ys(), size_t(count), graph.value(to), out); }) {
+			Distance::batch(graph.xs() + first, graph.ys() + first, count, graph.value(to), out);
+		}
+		else { for (int i = 0; i < count; ++i) { out[i] = (*this)(graph, first + i, to); } }
+	}
+};
+
+// Fill out with the heuristic from each of count nodes starting at first to goal, in one batch for heuristics that support it
+// (DistanceHeuristic), otherwise by calling it for each node
+template<class Graph, class HeuristicFunc, class Weight>
+void evaluateHeuristicRange(const Graph& graph, const HeuristicFunc& heuristicFunc, int first, int count, int goal, Weight* out) {
+	if constexpr (requires { heuristicFunc.evaluateRange(graph, first, count, goal, out); }) { heuristicFunc.evaluateRange(graph, first, count, goal, out); }
+	else { for (int i = 0; i < count; ++i) { out[i] = heuristicFunc(graph, first + i, goal); } }
+}
+
+// Heuristic which just measures the distance between the values of the two nodes
+template<typename ValueType, typename WeightType>
+Heuristic<ValueType, WeightType> distanceHeuristic(WeightType(*distanceFunc)(const ValueType&, const ValueType&)) {
+	return [distanceFunc](const CompressedGraph<ValueType, WeightType>& graph, int from, int to) { return distanceFunc(graph.value(from), graph.value(to)); };
+}
\ No newline at end of file
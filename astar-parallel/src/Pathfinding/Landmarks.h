@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+#include "../Threading/ThreadPool.h"
+
+// How landmarks are picked.
+// Farthest repeatedly takes the node farthest from every landmark so far, which spreads them around the edges of the graph.
+// Avoid (Goldberg & Werneck, 2005) grows a shortest path tree from a random node, weights each node by how badly the current
+// landmarks bound its distance from the root, and places the next landmark at the end of the worst-covered branch.
+enum class LandmarkSelection { Farthest, Avoid };
+
+// Precomputed distances for the ALT (A*, Landmarks, Triangle inequality) heuristic (Goldberg & Harrelson, 2005).
+// Exact distances from a handful of landmark nodes to every node, and from every node back to them, give by the triangle inequality
+//   d(u, v) >= d(L, v) - d(L, u)   and   d(u, v) >= d(u, L) - d(v, L)
+// for every landmark L. Unlike a purely geometric heuristic this follows the shape of the graph itself, so the bound stays tight around obstacles.
+template<class Weight>
+class Landmarks
+{
+public:
+	Landmarks() = default;
+
+	// Pick numLandmarks landmarks from graph and precompute their distance tables.
+	// Graph must provide reverseAdjacency(index) as well as the usual interface, ie. CompressedGraph
+	template<class Graph>
+	Landmarks(const Graph& graph, int numLandmarks, LandmarkSelection selection, unsigned int seed = 0) : m_numNodes(graph.size()) {
+		if (graph.size() == 0) { return; }
+		numLandmarks = std::clamp(numLandmarks, 0, static_cast<int>(graph.size()));
+
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution<int> nodeDistribution(0, static_cast<int>(graph.size()) - 1);
+		std::vector<bool> isLandmark(graph.size(), false);
+
+		// Kept one table per landmark while selecting, and interleaved by node at the end
+		std::vector<std::vector<Weight>> fromLandmark, toLandmark;
+
+		auto addLandmark = [&](int landmark) {
+			m_landmarks.push_back(landmark); isLandmark[landmark] = true;
+			fromLandmark.emplace_back(); toLandmark.emplace_back();
+			// Forward and backward searches don't depend on each other, so run on two threads
+			auto search = [&](int direction) {
+				if (direction == 0) { dijkstra(graph, landmark, false, fromLandmark.back()); }
+				else { dijkstra(graph, landmark, true, toLandmark.back()); }
+			};
+			ThreadPool::shared().run(2, search);
+		};
+
+		auto randomNonLandmark = [&]() { int node; do { node = nodeDistribution(gen); } while (isLandmark[node]); return node; };
+
+		if (selection == LandmarkSelection::Farthest) {
+			// Shortest distance in either direction between each node and any landmark so far. Seeded with distances from a random
+			// node so the first landmark is as far from that as possible, then reset once there's a real landmark to measure from
+			std::vector<Weight> nearest;
+			dijkstra(graph, nodeDistribution(gen), false, nearest);
+
+			while (m_landmarks.size() < numLandmarks) {
+				// Farthest reachable node, or if there are none left one in a part of the graph no landmark can reach
+				int farthest = -1;
+				for (int i = 0; i < graph.size(); ++i) {
+					if (isLandmark[i] || nearest[i] == unreachable) { continue; }
+					if (farthest == -1 || nearest[i] > nearest[farthest]) { farthest = i; }
+				}
+				addLandmark(farthest != -1 ? farthest : randomNonLandmark());
+
+				if (m_landmarks.size() == 1) { std::fill(nearest.begin(), nearest.end(), unreachable); }
+				for (int i = 0; i < graph.size(); ++i) { nearest[i] = std::min({ nearest[i], fromLandmark.back()[i], toLandmark.back()[i] }); }
+			}
+		}
+		else {
+			std::vector<Weight> rootDistance, subtreeSize(graph.size());
+			std::vector<int> parent, settleOrder, heaviestChild(graph.size());
+			std::vector<bool> containsLandmark(graph.size());
+
+			while (m_landmarks.size() < numLandmarks) {
+				int root = nodeDistribution(gen);
+				dijkstra(graph, root, false, rootDistance, &parent, &settleOrder);
+
+				// Lower bound on the distance from root using the landmarks chosen so far
+				auto boundFromRoot = [&](int node) {
+					Weight bound = 0;
+					for (int l = 0; l < m_landmarks.size(); ++l) {
+						bound = std::max(bound, landmarkBound(fromLandmark[l][root], fromLandmark[l][node], toLandmark[l][root], toLandmark[l][node]));
+					}
+					return bound;
+				};
+
+				// Size of a subtree is the total error of the bound over it, or zero if it already contains a landmark.
+				// Settle order reversed visits children before parents, so each subtree is complete before being added to its parent
+				std::fill(subtreeSize.begin(), subtreeSize.end(), Weight(0));
+				std::fill(heaviestChild.begin(), heaviestChild.end(), -1);
+				std::fill(containsLandmark.begin(), containsLandmark.end(), false);
+				for (auto it = settleOrder.rbegin(); it != settleOrder.rend(); ++it) {
+					int node = *it;
+					if (isLandmark[node]) { containsLandmark[node] = true; }
+					subtreeSize[node] = containsLandmark[node] ? Weight(0) : subtreeSize[node] + (rootDistance[node] - boundFromRoot(node));
+
+					int nodeParent = parent[node];
+					if (nodeParent == -1) { continue; }
+					if (containsLandmark[node]) { containsLandmark[nodeParent] = true; }
+					subtreeSize[nodeParent] += subtreeSize[node];
+					if (heaviestChild[nodeParent] == -1 || subtreeSize[node] > subtreeSize[heaviestChild[nodeParent]]) { heaviestChild[nodeParent] = node; }
+				}
+
+				// Walk down from the heaviest subtree to a leaf. If every subtree is already covered, fall back to a random node
+				int heaviest = *std::max_element(settleOrder.begin(), settleOrder.end(), [&](int lhs, int rhs) { return subtreeSize[lhs] < subtreeSize[rhs]; });
+				if (subtreeSize[heaviest] <= 0) { addLandmark(randomNonLandmark()); continue; }
+				while (heaviestChild[heaviest] != -1) { heaviest = heaviestChild[heaviest]; }
+				addLandmark(heaviest);
+			}
+		}
+
+		m_fromLandmark.resize(graph.size() * m_landmarks.size());
+		m_toLandmark.resize(graph.size() * m_landmarks.size());
+		for (int i = 0; i < graph.size(); ++i) {
+			for (int l = 0; l < m_landmarks.size(); ++l) {
+				m_fromLandmark[i * m_landmarks.size() + l] = fromLandmark[l][i];
+				m_toLandmark[i * m_landmarks.size() + l] = toLandmark[l][i];
+			}
+		}
+	}
+
+	// Lower bound on the cost of the shortest path from one node to another
+	Weight lowerBound(int from, int to) const {
+		size_t numLandmarks = m_landmarks.size();
+		size_t fromRow = from * numLandmarks, toRow = to * numLandmarks;
+		Weight bound = 0;
+		for (size_t l = 0; l < numLandmarks; ++l) {
+			bound = std::max(bound, landmarkBound(m_fromLandmark[fromRow + l], m_fromLandmark[toRow + l], m_toLandmark[fromRow + l], m_toLandmark[toRow + l]));
+		}
+		return bound;
+	}
+
+	const std::vector<int>& landmarks() const { return m_landmarks; }
+	size_t numNodes() const { return m_numNodes; }
+
+private:
+	static constexpr Weight unreachable = std::numeric_limits<Weight>::max();
+
+	std::vector<int> m_landmarks;
+	size_t m_numNodes = 0;
+
+	// Distance from each landmark to each node, and from each node to each landmark.
+	// Stored node by node, so looking up every landmark for a node reads one contiguous run
+	std::vector<Weight> m_fromLandmark, m_toLandmark;
+
+	// Bound on d(from, to) given by one landmark, or zero where the landmark can't reach (or be reached from) both nodes
+	static Weight landmarkBound(Weight landmarkToFrom, Weight landmarkToTo, Weight fromToLandmark, Weight toToLandmark) {
+		Weight bound = 0;
+		if (landmarkToFrom != unreachable && landmarkToTo != unreachable) { bound = std::max(bound, landmarkToTo - landmarkToFrom); }
+		if (fromToLandmark != unreachable && toToLandmark != unreachable) { bound = std::max(bound, fromToLandmark - toToLandmark); }
+		return bound;
+	}
+
+	// Plain Dijkstra from source over outgoing edges, or incoming edges if backward, filling distance for every node.
+	// Optionally also records each node's parent in the shortest path tree and the order nodes were settled in
+	template<class Graph>
+	static void dijkstra(const Graph& graph, int source, bool backward, std::vector<Weight>& distance, std::vector<int>* parent = nullptr, std::vector<int>* settleOrder = nullptr) {
+		distance.assign(graph.size(), unreachable);
+		if (parent) { parent->assign(graph.size(), -1); }
+		if (settleOrder) { settleOrder->clear(); }
+
+		using QueueEntry = std::pair<Weight, int>;
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+		distance[source] = 0;
+		queue.emplace(Weight(0), source);
+
+		while (!queue.empty()) {
+			auto [cost, current] = queue.top();
+			queue.pop();
+			// Superseded by a shorter route pushed later
+			if (cost > distance[current]) { continue; }
+			if (settleOrder) { settleOrder->push_back(current); }
+
+			auto relax = [&](const auto& edges) {
+				for (auto [neighbour, edgeWeight] : edges) {
+					Weight tentativeCost = cost + edgeWeight;
+					if (tentativeCost < distance[neighbour]) {
+						distance[neighbour] = tentativeCost;
+						if (parent) { (*parent)[neighbour] = current; }
+						queue.emplace(tentativeCost, neighbour);
+					}
+				}
+			};
+			if (backward) { relax(graph.reverseAdjacency(current)); } else { relax(graph.adjacency(current)); }
+		}
+	}
+};
\ No newline at end of file
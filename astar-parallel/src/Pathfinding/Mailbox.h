@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <utility>
+
+// Lock-free multiple-producer single-consumer queue of messages.
+// Producers post whole batches, which are pushed onto an atomic singly-linked list with a compare-and-swap;
+// the consumer takes every pending batch at once by swapping the head for null. Because the consumer never removes
+// individual nodes there's no ABA problem, and allocation is amortised over the size of each batch.
+// Batches are not delivered in any particular order, so this is only suitable where message order doesn't matter.
+template<class Message>
+class Mailbox
+{
+public:
+	Mailbox() = default;
+	Mailbox(const Mailbox&) = delete;
+	Mailbox& operator=(const Mailbox&) = delete;
+	~Mailbox() { drain([](const Message&) {}); }
+
+	// Safe to call from any thread
+	void post(std::vector<Message>&& messages) {
+		if (messages.empty()) { return; }
+		Batch* batch = new Batch{ std::move(messages), m_head.load(std::memory_order_relaxed) };
+		while (!m_head.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+	// Only to be called from the owning thread. Calls func on every pending message and returns how many there were
+	template<class Func>
+	size_t drain(Func&& func) {
+		Batch* batch = m_head.exchange(nullptr, std::memory_order_acquire);
+		size_t numMessages = 0;
+		while (batch) {
+			for (const Message& message : batch->messages) { func(message); }
+			numMessages += batch->messages.size();
+			Batch* next = batch->next;
+			delete batch;
+			batch = next;
+		}
+		return numMessages;
+	}
+
+	bool isEmpty() const { return m_head.load(std::memory_order_acquire) == nullptr; }
+
+private:
+	struct Batch {
+		std::vector<Message> messages;
+		Batch* next;
+	};
+
+	std::atomic<Batch*> m_head = nullptr;
+};
\ No newline at end of file
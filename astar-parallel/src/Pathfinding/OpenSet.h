@@ -0,0 +1,207 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <bit>
+
+// Open set policies for aStarSequential. Each holds (f, index) entries and hands back the lowest f first, and keeps its storage
+// on clear() so it can be reused between queries.
+// IndexedHeapOpenSet holds at most one entry per node, lowering its key in place. The other two never change a key once pushed:
+// a node whose f score is lowered is simply pushed again, and the search skips the older, higher entry when it comes out.
+
+// Indexed 4-ary heap with decrease-key. A position map from node index to heap slot means pushing a node which is already in the
+// heap just lowers its key and sifts it up, so there are no duplicate entries to pop and throw away. Four children per node makes
+// the heap half as deep as a binary one, and the four children sit next to each other in memory, so sifting down touches fewer
+// cache lines for the extra comparisons.
+template<class Weight>
+class IndexedHeapOpenSet
+{
+public:
+	struct Entry { Weight estimatedTotalCost; int index; };
+
+	// Position map only covers nodes which have been pushed, so resetting it just means visiting what's left in the heap
+	void clear() {
+		for (const Entry& entry : m_heap) { m_position[entry.index] = notInHeap; }
+		m_heap.clear();
+	}
+	bool empty() const { return m_heap.empty(); }
+	size_t size() const { return m_heap.size(); }
+	bool contains(int index) const { return index < m_position.size() && m_position[index] != notInHeap; }
+
+	// Add index with the given key, or lower its key if it's already in the heap and the new one is lower.
+	// Returns whether a new entry was added
+	bool push(Weight estimatedTotalCost, int index) {
+		if (index >= m_position.size()) { m_position.resize(index + 1, notInHeap); }
+		int position = m_position[index];
+		if (position == notInHeap) {
+			m_heap.push_back(Entry{ estimatedTotalCost, index });
+			siftUp(static_cast<int>(m_heap.size()) - 1);
+			return true;
+		}
+		if (estimatedTotalCost < m_heap[position].estimatedTotalCost) {
+			m_heap[position].estimatedTotalCost = estimatedTotalCost;
+			siftUp(position);
+		}
+		return false;
+	}
+
+	const Entry& top() const { return m_heap.front(); }
+
+	Entry pop() {
+		Entry entry = m_heap.front();
+		m_position[entry.index] = notInHeap;
+		Entry last = m_heap.back();
+		m_heap.pop_back();
+		if (!m_heap.empty()) {
+			m_heap.front() = last;
+			m_position[last.index] = 0;
+			siftDown(0);
+		}
+		return entry;
+	}
+
+private:
+	static constexpr int arity = 4;
+	static constexpr int notInHeap = -1;
+
+	std::vector<Entry> m_heap;
+	std::vector<int> m_position;
+
+	// Moves the entry at position up or down, shifting the entries it passes into the gap rather than swapping at every level
+	void siftUp(int position) {
+		Entry entry = m_heap[position];
+		while (position > 0) {
+			int parent = (position - 1) / arity;
+			if (!(entry.estimatedTotalCost < m_heap[parent].estimatedTotalCost)) { break; }
+			place(position, m_heap[parent]);
+			position = parent;
+		}
+		place(position, entry);
+	}
+
+	void siftDown(int position) {
+		Entry entry = m_heap[position];
+		int size = static_cast<int>(m_heap.size());
+		while (true) {
+			int firstChild = position * arity + 1;
+			if (firstChild >= size) { break; }
+			int smallest = firstChild;
+			for (int child = firstChild + 1; child < std::min(firstChild + arity, size); ++child) {
+				if (m_heap[child].estimatedTotalCost < m_heap[smallest].estimatedTotalCost) { smallest = child; }
+			}
+			if (!(m_heap[smallest].estimatedTotalCost < entry.estimatedTotalCost)) { break; }
+			place(position, m_heap[smallest]);
+			position = smallest;
+		}
+		place(position, entry);
+	}
+
+	void place(int position, const Entry& entry) {
+		m_heap[position] = entry;
+		m_position[entry.index] = position;
+	}
+};
+
+// General purpose binary heap, which works for any heuristic
+template<class Weight>
+class BinaryHeapOpenSet
+{
+public:
+	struct Entry { Weight estimatedTotalCost; int index; };
+
+	void clear() { m_heap.clear(); }
+	bool empty() const { return m_heap.empty(); }
+	size_t size() const { return m_heap.size(); }
+
+	void push(Weight estimatedTotalCost, int index) {
+		m_heap.push_back(Entry{ estimatedTotalCost, index });
+		std::push_heap(m_heap.begin(), m_heap.end(), greaterEstimatedCost);
+	}
+
+	Entry pop() {
+		std::pop_heap(m_heap.begin(), m_heap.end(), greaterEstimatedCost);
+		Entry entry = m_heap.back();
+		m_heap.pop_back();
+		return entry;
+	}
+
+private:
+	static bool greaterEstimatedCost(const Entry& lhs, const Entry& rhs) { return lhs.estimatedTotalCost > rhs.estimatedTotalCost; }
+
+	std::vector<Entry> m_heap;
+};
+
+// Radix heap (Ahuja, Mehlhorn, Orlin & Tarjan, 1990) for searches whose popped keys never decrease, which holds for A* with a
+// consistent heuristic (f = g + h is then monotone along every path). Entries are bucketed by the highest bit in which their key
+// differs from the last key popped, so a push is O(1) and each entry is only moved to a lower bucket a bounded number of times,
+// instead of the O(log n) sift of a comparison heap.
+// Keys are bucketed by their exact bit pattern, with no quantisation; for non-negative floats the IEEE bit pattern read as an
+// unsigned integer orders the same way as the float itself. Should a key come in below the last one popped (an inconsistent
+// heuristic) it's filed as if equal to it, so the search still finishes, just no longer strictly in f order.
+template<class Weight>
+class RadixHeapOpenSet
+{
+public:
+	struct Entry { Weight estimatedTotalCost; int index; };
+
+	void clear() {
+		for (auto& bucket : m_buckets) { bucket.clear(); }
+		m_size = 0;
+		m_last = Weight(0);
+		m_lastBits = 0;
+	}
+	bool empty() const { return m_size == 0; }
+	size_t size() const { return m_size; }
+
+	void push(Weight estimatedTotalCost, int index) {
+		m_buckets[bucketOf(bitsOf(std::max(estimatedTotalCost, m_last)))].push_back(Entry{ estimatedTotalCost, index });
+		++m_size;
+	}
+
+	Entry pop() {
+		if (m_buckets[0].empty()) {
+			// Lowest non-empty bucket holds the minimum. Making that the new last key spreads the rest of the bucket into strictly
+			// lower buckets, since they all share its bits above the one that put them there
+			int i = 1;
+			while (m_buckets[i].empty()) { ++i; }
+			auto& bucket = m_buckets[i];
+			m_last = std::max(std::min_element(bucket.begin(), bucket.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.estimatedTotalCost < rhs.estimatedTotalCost; })->estimatedTotalCost, m_last);
+			m_lastBits = bitsOf(m_last);
+			for (const Entry& entry : bucket) {
+				m_buckets[bucketOf(bitsOf(std::max(entry.estimatedTotalCost, m_last)))].push_back(entry);
+			}
+			bucket.clear();
+		}
+		Entry entry = m_buckets[0].back();
+		m_buckets[0].pop_back();
+		--m_size;
+		return entry;
+	}
+
+private:
+	using Bits = std::conditional_t<sizeof(Weight) <= 4, std::uint32_t, std::uint64_t>;
+	static constexpr int numBits = static_cast<int>(sizeof(Bits) * 8);
+
+	static Bits bitsOf(Weight key) {
+		if constexpr (std::is_floating_point_v<Weight>) {
+			// Copy through an unsigned integer of matching size (float into uint32, double into uint64)
+			std::conditional_t<sizeof(Weight) == 4, std::uint32_t, std::uint64_t> bits;
+			std::memcpy(&bits, &key, sizeof(key));
+			return static_cast<Bits>(bits);
+		}
+		else { return static_cast<Bits>(key); }
+	}
+
+	// Bucket 0 holds keys equal to the last popped, bucket b keys whose highest differing bit is b - 1
+	int bucketOf(Bits bits) const { return static_cast<int>(std::bit_width(bits ^ m_lastBits)); }
+
+	std::array<std::vector<Entry>, numBits + 1> m_buckets;
+	size_t m_size = 0;
+	Weight m_last = Weight(0);
+	Bits m_lastBits = 0;
+};
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../Graph/CompressedGraph.h"
+
+#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include "Prototypes.h"
+#include "SearchContext.h"
+
+#include "../Threading/ThreadPool.h"
+#include "AtomicCostTable.h"
+#include "BidirectionalCostTables.h"
+
+// Parallel New Bidirectional A* (Rios & Chaimowicz, 2011).
+// The two sides of bidirectional A* run at the same time on two threads instead of taking turns. Each side owns its own g values
+// and open set; the only shared state is the best meeting cost, each side's lowest f score, and the per-node flags for M.
+// As soon as either side runs out of nodes both stop, and the best path found is optimal.
+// Graph must provide reverseAdjacency(index) as well as the usual interface, ie. CompressedGraph.
+// Only the SearchContext's bidirectional cost tables are used, which are reused between queries rather than allocated for each.
+template<class Graph, class HeuristicFunc = Heuristic<typename Graph::value_type, typename Graph::weight_type>>
+Path parallelBidirectionalAStar(const Graph& graph, int start, int goal, const HeuristicFunc& heuristicFunc, SearchContext<typename Graph::weight_type>& context) {
+	using Weight = typename Graph::weight_type;
+	const Weight maxWeight = std::numeric_limits<Weight>::max();
+
+	if (graph.size() == 0) { return Path(); }
+	if (start == goal) { return Path{ start }; }
+
+	// Each side estimates the distance to where the other side started from
+	auto hForward = [&](int index) { return heuristicFunc(graph, index, goal); };
+	auto hBackward = [&](int index) { return heuristicFunc(graph, start, index); };
+
+	// (g, parent) for each side, only ever written by the side's own thread but read by the other to find meeting points,
+	// and the flags for the nodes which neither side needs to look at again
+	BidirectionalCostTables<Weight>& tables = context.bidirectionalCostTables();
+	tables.beginQuery(graph.size());
+	using CostTable = typename BidirectionalCostTables<Weight>::Side;
+	CostTable& forwardCosts = tables.forward();
+	CostTable& backwardCosts = tables.backward();
+	// Single (cost, node) slot holding the length of the best path found so far and the node the sides met at
+	AtomicCostTable<Weight> bestMeeting(1);
+	// Lowest f score in each side's open set
+	std::atomic<Weight> forwardLowestCost = hForward(start), backwardLowestCost = hBackward(goal);
+	std::atomic<bool> finished = false;
+
+	// Both origins have to be in place before either side starts, or one side could run to completion without ever seeing the other
+	forwardCosts.tryLower(start, 0, -1);
+	backwardCosts.tryLower(goal, 0, -1);
+
+	auto sideFunc = [&](int sideIndex) {
+		bool isForward = sideIndex == 0;
+		CostTable& costs = isForward ? forwardCosts : backwardCosts;
+		const CostTable& otherCosts = isForward ? backwardCosts : forwardCosts;
+		std::atomic<Weight>& lowestCost = isForward ? forwardLowestCost : backwardLowestCost;
+		const std::atomic<Weight>& otherLowestCost = isForward ? backwardLowestCost : forwardLowestCost;
+		auto h = [&](int index) { return isForward ? hForward(index) : hBackward(index); };
+		auto otherH = [&](int index) { return isForward ? hBackward(index) : hForward(index); };
+
+		struct OpenSetEntry { Weight estimatedTotalCost, costFromStart; int index; };
+		struct GreaterEstimatedCost { bool operator()(const OpenSetEntry& lhs, const OpenSetEntry& rhs) const { return lhs.estimatedTotalCost > rhs.estimatedTotalCost; } };
+		std::priority_queue<OpenSetEntry, std::vector<OpenSetEntry>, GreaterEstimatedCost> openSet;
+
+		int origin = isForward ? start : goal;
+		openSet.push(OpenSetEntry{ h(origin), 0, origin });
+
+		while (!openSet.empty() && !finished.load(std::memory_order_relaxed)) {
+			OpenSetEntry entry = openSet.top();
+			openSet.pop();
+			int current = entry.index;
+
+			if (!tables.inM(current) && entry.costFromStart <= costs.cost(current)) {
+				tables.addToM(current);
+
+				Weight bestCost = bestMeeting.cost(0);
+				bool couldImprove = entry.estimatedTotalCost < bestCost && entry.costFromStart + otherLowestCost.load() - otherH(current) < bestCost;
+
+				if (couldImprove) {
+					auto expand = [&](const auto& edges) {
+						for (auto [neighbour, edgeWeight] : edges) {
+							if (tables.inM(neighbour)) { continue; }
+
+							Weight tentativeNeighbourCost = entry.costFromStart + edgeWeight;
+							if (costs.tryLower(neighbour, tentativeNeighbourCost, current)) {
+								openSet.push(OpenSetEntry{ tentativeNeighbourCost + h(neighbour), tentativeNeighbourCost, neighbour });
+
+								// Reached by both sides, so there is a path through here. Both tables are sequentially consistent,
+								// so if the other side is lowering its cost here at the same time at least one of us sees the other's write
+								Weight otherCost = otherCosts.cost(neighbour);
+								if (otherCost != maxWeight) { bestMeeting.tryLower(0, tentativeNeighbourCost + otherCost, neighbour); }
+							}
+						}
+					};
+					if (isForward) { expand(graph.adjacency(current)); } else { expand(graph.reverseAdjacency(current)); }
+				}
+			}
+
+			// Clear out stale entries so the top gives this side's lowest f score, and publish it to the other side
+			while (!openSet.empty() && (tables.inM(openSet.top().index) || openSet.top().costFromStart > costs.cost(openSet.top().index))) { openSet.pop(); }
+			if (!openSet.empty()) { lowestCost.store(openSet.top().estimatedTotalCost); }
+		}
+
+		// One side running out of nodes means no better path can exist, so stop the other
+		finished.store(true);
+	};
+
+	// Forward side runs on the calling thread and backward on a pool worker
+	ThreadPool::shared().run(2, sideFunc);
+
+	int meetingNode = bestMeeting.parent(0);
+
+	// Fail state
+	if (meetingNode == -1) { return Path(); }
+
+	// Forward half runs from the meeting node back to start, so is reversed
+	Path path;
+	for (int index = meetingNode; index != -1; index = forwardCosts.parent(index)) { path.push_back(index); }
+	std::reverse(path.begin(), path.end());
+	// Backward parents already point towards the goal
+	for (int index = backwardCosts.parent(meetingNode); index != -1; index = backwardCosts.parent(index)) { path.push_back(index); }
+	return path;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+// Cost of the best path to the goal found so far, shared between threads.
+// Any node whose f score is no lower than this can't lead to a better path (given an admissible heuristic), so can be pruned.
+template<class Weight>
+class Incumbent
+{
+public:
+	Weight get() const { return m_cost.load(std::memory_order_acquire); }
+
+	// Lower the incumbent cost if the given cost is better. Returns whether it was lowered
+	bool tryLower(Weight cost) {
+		Weight current = m_cost.load(std::memory_order_relaxed);
+		while (cost < current) {
+			if (m_cost.compare_exchange_weak(current, cost, std::memory_order_acq_rel, std::memory_order_relaxed)) { return true; }
+		}
+		return false;
+	}
+
+	bool found() const { return get() < std::numeric_limits<Weight>::max(); }
+
+private:
+	std::atomic<Weight> m_cost = std::numeric_limits<Weight>::max();
+};
+
+// Distributed termination detection by counting outstanding work, after Mattern's message counting method.
+// Mattern compares the number of messages sent against the number received; in shared memory the two counts can live in a single
+// atomic, so here senders add to the count before their work becomes visible to anyone else and receivers subtract once it has been
+// fully dealt with. As long as every increment happens before the work it covers is handed over, the count can only reach zero once
+// no thread holds or is about to receive any work, and can never rise again after that, so reading zero means the search is over.
+class TerminationDetector
+{
+public:
+	TerminationDetector(long long initialWork = 0) : m_outstanding(initialWork) {}
+
+	void addWork(long long amount = 1) { m_outstanding.fetch_add(amount, std::memory_order_acq_rel); }
+	void removeWork(long long amount = 1) { m_outstanding.fetch_sub(amount, std::memory_order_acq_rel); }
+
+	bool isTerminated() const { return m_outstanding.load(std::memory_order_acquire) == 0; }
+
+private:
+	std::atomic<long long> m_outstanding;
+};
\ No newline at end of file
@@ -1,13 +1,21 @@
 #pragma once
 
 #include "../Graph/DirectedGraph.h"
+#include "../Graph/CompressedGraph.h"
+#include "SearchContext.h"
 #include <functional>
 #include <vector>
 
 using Path = std::vector<int>;
 
+// Distance between two values, eg. the positions of two nodes
 template<typename ValueType, typename WeightType>
-using Heuristic = std::function<WeightType(const ValueType&, const ValueType&)>;
+using DistanceFunction = std::function<WeightType(const ValueType&, const ValueType&)>;
 
+// Estimated cost from one node to another, given by index. Taking indices rather than values lets a heuristic use
+// precomputed per-node data (eg. landmark distances) as well as the values stored in the graph
 template<typename ValueType, typename WeightType>
-using PathfindingAlgorithm = std::function<Path(const DirectedGraph<ValueType, WeightType>&, int, int, const Heuristic<ValueType,WeightType>&)>;
\ No newline at end of file
+using Heuristic = std::function<WeightType(const CompressedGraph<ValueType, WeightType>&, int, int)>;
+
+template<typename ValueType, typename WeightType>
+using PathfindingAlgorithm = std::function<Path(const CompressedGraph<ValueType, WeightType>&, int, int, const Heuristic<ValueType,WeightType>&, SearchContext<WeightType>&)>;
\ No newline at end of file
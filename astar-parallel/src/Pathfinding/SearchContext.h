@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+#include "HeuristicCache.h"
+#include "BidirectionalCostTables.h"
+#include "SearchStats.h"
+
+// Per-node search state which persists across queries, so that a query only pays for the nodes it actually touches.
+// Each entry is stamped with the generation of the query which last wrote it; beginQuery just bumps the current generation,
+// so any entry with an older stamp reads back as unvisited without the buffers needing to be refilled.
+template<class Weight>
+class SearchContext
+{
+public:
+	// Prepare for a new query over a graph with the given number of nodes
+	void beginQuery(size_t graphSize) {
+		if (m_entries.size() < graphSize) { m_entries.resize(graphSize); }
+		// Stamps would become ambiguous once the counter wraps, so do a full reset in that (very rare) case
+		if (++m_generation == 0) {
+			for (auto& entry : m_entries) { entry.generation = 0; }
+			m_generation = 1;
+		}
+		for (auto& [type, openSet] : m_openSets) { openSet.clear(openSet.storage.get()); }
+	}
+
+	bool visited(int index) const { return m_entries[index].generation == m_generation; }
+
+	Weight costFromStart(int index) const { return visited(index) ? m_entries[index].costFromStart : std::numeric_limits<Weight>::max(); }
+	Weight estimatedTotalCost(int index) const { return visited(index) ? m_entries[index].estimatedTotalCost : std::numeric_limits<Weight>::max(); }
+	int parentIndex(int index) const { return visited(index) ? m_entries[index].parentIndex : -1; }
+
+	void set(int index, Weight costFromStart, Weight estimatedTotalCost, int parentIndex) {
+		Entry& entry = m_entries[index];
+		if (!visited(index)) { entry.closed = false; entry.hasHeuristic = false; }
+		entry.costFromStart = costFromStart; entry.estimatedTotalCost = estimatedTotalCost; entry.parentIndex = parentIndex;
+		entry.generation = m_generation;
+	}
+
+	bool closed(int index) const { return visited(index) && m_entries[index].closed; }
+	void close(int index) {
+		if (!visited(index)) { set(index, std::numeric_limits<Weight>::max(), std::numeric_limits<Weight>::max(), -1); }
+		m_entries[index].closed = true;
+	}
+
+	// Heuristic at index for this query, calling compute(index) the first time it's asked for and returning the stored value after that.
+	// Kept in the same entry as g and f, which the search is already reading, so a hit costs no extra memory access
+	template<class Compute>
+	Weight heuristic(int index, Compute&& compute) {
+		if (!visited(index)) { set(index, std::numeric_limits<Weight>::max(), std::numeric_limits<Weight>::max(), -1); }
+		Entry& entry = m_entries[index];
+		if (!entry.hasHeuristic) { entry.heuristic = compute(index); entry.hasHeuristic = true; }
+		return entry.heuristic;
+	}
+
+	// Separate heuristic cache for searches whose threads share one context, which (unlike the entries) is safe to use from several
+	// threads at once. Not touched by beginQuery, so its own beginQuery has to be called at the start of each query
+	HeuristicCache<Weight>& heuristicCache() { return m_heuristicCache; }
+
+	// Tables for parallel bidirectional A*, whose two sides share them from different threads. Not touched by beginQuery either,
+	// so the search calls their own beginQuery
+	BidirectionalCostTables<Weight>& bidirectionalCostTables() { return m_bidirectionalCostTables; }
+
+	// Counters from the last query, for searches which record them. Also not touched by beginQuery, since searches size it by thread count
+	SearchStats& stats() { return m_stats; }
+	const SearchStats& stats() const { return m_stats; }
+
+	// Second context for searches which also run backwards from the goal
+	SearchContext& reverse() {
+		if (!m_reverse) { m_reverse = std::make_unique<SearchContext>(); }
+		return *m_reverse;
+	}
+
+	// Open set of the given type, created on first use and kept so its capacity carries over between queries.
+	// Keyed by type, so algorithms using different open set policies can share one context. Cleared by beginQuery
+	template<class OpenSet>
+	OpenSet& openSet() {
+		auto& openSet = m_openSets[typeid(OpenSet)];
+		if (!openSet.storage) {
+			openSet.storage = std::make_shared<OpenSet>();
+			openSet.clear = [](void* storage) { static_cast<OpenSet*>(storage)->clear(); };
+		}
+		return *static_cast<OpenSet*>(openSet.storage.get());
+	}
+
+private:
+	struct Entry {
+		Weight costFromStart, estimatedTotalCost, heuristic;
+		int parentIndex;
+		unsigned int generation = 0;
+		bool closed = false, hasHeuristic = false;
+	};
+
+	std::vector<Entry> m_entries;
+	struct StoredOpenSet {
+		std::shared_ptr<void> storage;
+		void (*clear)(void*) = nullptr;
+	};
+	std::unordered_map<std::type_index, StoredOpenSet> m_openSets;
+	HeuristicCache<Weight> m_heuristicCache;
+	BidirectionalCostTables<Weight> m_bidirectionalCostTables;
+	SearchStats m_stats;
+	unsigned int m_generation = 0;
+
+	std::unique_ptr<SearchContext> m_reverse;
+};
\ No newline at end of file
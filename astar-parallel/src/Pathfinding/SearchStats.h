@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+
+// Search instrumentation is compiled out unless ASTAR_SEARCH_STATS is defined as non-zero (eg. added to the project's preprocessor
+// definitions), since updating counters from the inner loops costs time of its own. With it off every recording function below is empty
+#ifndef ASTAR_SEARCH_STATS
+#define ASTAR_SEARCH_STATS 0
+#endif
+
+constexpr bool searchStatsEnabled = ASTAR_SEARCH_STATS != 0;
+
+// Work done by one thread over a query. Aligned so that threads updating their own counters don't share cache lines
+struct alignas(64) ThreadSearchStats
+{
+	long long nodesExpanded = 0;
+	// Nodes expanded again after a cheaper route to them was found, included in nodesExpanded
+	long long reExpansions = 0;
+	// Edges which lowered the cost of the node they lead to
+	long long edgesRelaxed = 0;
+	size_t openSetPeak = 0;
+	// Time spent blocked on another thread's lock, and time spent with no work waiting for more or for the search to end
+	std::chrono::nanoseconds lockWait = std::chrono::nanoseconds(0), idleWait = std::chrono::nanoseconds(0);
+
+	void expanded(bool reExpansion = false) {
+		if constexpr (searchStatsEnabled) { ++nodesExpanded; if (reExpansion) { ++reExpansions; } }
+	}
+	void relaxed() {
+		if constexpr (searchStatsEnabled) { ++edgesRelaxed; }
+	}
+	void openSetSize(size_t size) {
+		if constexpr (searchStatsEnabled) { openSetPeak = std::max(openSetPeak, size); }
+	}
+
+	// Lock the mutex, adding any time spent waiting for it to lockWait. Uncontended locks aren't timed
+	template<class Mutex>
+	std::unique_lock<Mutex> lock(Mutex& mutex) {
+		if constexpr (searchStatsEnabled) {
+			std::unique_lock<Mutex> lock(mutex, std::try_to_lock);
+			if (!lock.owns_lock()) {
+				auto begin = std::chrono::steady_clock::now();
+				lock.lock();
+				lockWait += std::chrono::steady_clock::now() - begin;
+			}
+			return lock;
+		}
+		else { return std::unique_lock<Mutex>(mutex); }
+	}
+
+	// Mark the thread as out of work, or as having work again, timing the gaps in between. Repeated calls are ignored
+	void beginIdle() {
+		if constexpr (searchStatsEnabled) { if (!m_idle) { m_idle = true; m_idleSince = std::chrono::steady_clock::now(); } }
+	}
+	void endIdle() {
+		if constexpr (searchStatsEnabled) { if (m_idle) { m_idle = false; idleWait += std::chrono::steady_clock::now() - m_idleSince; } }
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_idleSince;
+	bool m_idle = false;
+};
+
+// Counters for the last query run with a SearchContext, one set per thread the search used
+class SearchStats
+{
+public:
+	void reset(int numThreads) {
+		if constexpr (searchStatsEnabled) { m_threads.assign(numThreads, ThreadSearchStats()); }
+	}
+	void clear() { m_threads.clear(); }
+
+	// Each thread should only write to its own. With stats disabled every thread shares one set, which nothing writes to
+	ThreadSearchStats& thread(int threadIndex) {
+		if constexpr (searchStatsEnabled) { return m_threads[threadIndex]; }
+		else { return m_unused; }
+	}
+	const std::vector<ThreadSearchStats>& threads() const { return m_threads; }
+	bool empty() const { return m_threads.empty(); }
+
+	// Every thread's counters added together. Open set peaks are added too, so are an upper bound on the combined peak
+	ThreadSearchStats total() const {
+		ThreadSearchStats total;
+		for (auto& thread : m_threads) {
+			total.nodesExpanded += thread.nodesExpanded;
+			total.reExpansions += thread.reExpansions;
+			total.edgesRelaxed += thread.edgesRelaxed;
+			total.openSetPeak += thread.openSetPeak;
+			total.lockWait += thread.lockWait;
+			total.idleWait += thread.idleWait;
+		}
+		return total;
+	}
+
+private:
+	std::vector<ThreadSearchStats> m_threads;
+	ThreadSearchStats m_unused;
+};
\ No newline at end of file
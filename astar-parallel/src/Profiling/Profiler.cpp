@@ -2,7 +2,11 @@
 
 Profiler::Profiler(int numIterations) : m_numIterations(numIterations) {}
 
+int Profiler::numIterations() const { return m_numIterations; }
 TimeStatistics Profiler::timingResults() const { return TimeStatistics(m_timingResults); }
+const std::vector<size_t>& Profiler::resultSizes() const { return m_resultSizes; }
+
+void Profiler::setIterationCallback(const std::function<void()>& callback) { m_iterationCallback = callback; }
 
 
 ProfilerBlocking::ProfilerBlocking(int numIterations) : Profiler(numIterations) {}
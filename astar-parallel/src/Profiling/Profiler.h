@@ -8,13 +8,14 @@
 #include "Timer.h"
 #include "TimeStatistics.h"
 
-#include "../Window/Window.h"
-
 class Profiler
 {
 protected:
 	int m_numIterations;
 	std::vector<TimeCompound> m_timingResults;
+	// Size of what each query returned when profiling a query set, ie. its path length
+	std::vector<size_t> m_resultSizes;
+	std::function<void()> m_iterationCallback;
 
 	Profiler(int numIterations);
 
@@ -33,15 +34,44 @@ protected:
 			timer.stop();
 			m_timingResults.emplace_back(timer.elapsedTime());
 
-			// Request redraw between iterations so output works
-			Window::requestRedrawThreadsafe();
+			// Lets a window redraw between iterations so output works. Nothing to do when running headless
+			if (m_iterationCallback) { m_iterationCallback(); }
+		}
+	}
+
+	// Runs func once for each query, which is anything with start and goal members, as func(graph, start, goal, others...).
+	// Each query counts as one iteration, so numIterations should be the number of queries
+	template <typename R, typename ...A, typename Queries, typename GraphArg, typename ...OtherArgs>
+	void profileQueries(const std::function<R(A...)>& func, const Queries& queries, GraphArg graph, OtherArgs... others) {
+		// Warm up as in profile()
+		if (queries.empty()) { return; }
+		func(graph, queries.front().start, queries.front().goal, others...);
+
+		Timer timer;
+		m_timingResults.clear(); m_timingResults.reserve(queries.size());
+		m_resultSizes.clear(); m_resultSizes.reserve(queries.size());
+
+		for (auto& query : queries) {
+			timer.start();
+			R result = func(graph, query.start, query.goal, others...);
+			timer.stop();
+			m_timingResults.emplace_back(timer.elapsedTime());
+			m_resultSizes.push_back(result.size());
+
+			if (m_iterationCallback) { m_iterationCallback(); }
 		}
 	}
 
 public:
 	virtual ~Profiler() = default;
 
+	// Called after every iteration, from whichever thread is profiling
+	void setIterationCallback(const std::function<void()>& callback);
+
+	int numIterations() const;
 	TimeStatistics timingResults() const;
+	// Empty unless a query set was profiled
+	const std::vector<size_t>& resultSizes() const;
 };
 
 
@@ -55,6 +85,11 @@ public:
 	void performProfiling(const std::function<R(A...)>& func, PassedArgs... args) {
 		profile(func, args...);
 	}
+
+	template <typename R, typename ...A, typename Queries, typename ...PassedArgs>
+	void performQueryProfiling(const std::function<R(A...)>& func, const Queries& queries, PassedArgs... args) {
+		profileQueries(func, queries, args...);
+	}
 };
 
 
@@ -81,6 +116,21 @@ public:
 		launchThread.detach();
 	}
 
+	// Queries are copied to the profiling thread, so needn't outlive the call
+	template <typename R, typename ...A, typename Queries, typename ...PassedArgs>
+	void startQueryProfiling(const std::function<R(A...)>& func, const Queries& queries, PassedArgs... args) {
+
+		auto threadFunction =
+		[&]<typename ...ThreadArgs>(Queries threadQueries, ThreadArgs... threadArgs) {
+			profileQueries(func, threadQueries, threadArgs...);
+			m_inProgressSemaphore.release();
+		};
+
+		m_inProgressSemaphore.acquire();
+		std::thread launchThread(threadFunction, queries, args...);
+		launchThread.detach();
+	}
+
 	bool isFinished();
 	int jobsCompleted() const;
 };
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "QuerySet.h"
+
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+#include "../StringUtil.h"
+
+QuerySet::QuerySet(const std::vector<Query>& queries) : m_queries(queries) {}
+
+QuerySet QuerySet::uniform(int numNodes, int count, unsigned int seed) {
+	if (numNodes <= 0) { return QuerySet(); }
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> nodeDistribution(0, numNodes - 1);
+	std::vector<Query> queries;
+	queries.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		int start = nodeDistribution(gen), goal = nodeDistribution(gen);
+		while (goal == start && numNodes > 1) { goal = nodeDistribution(gen); }
+		queries.push_back(Query{ start, goal });
+	}
+	return QuerySet(queries);
+}
+
+QuerySet QuerySet::distanceBanded(const CompressedGraph<Vec2, float>& graph, int count, int numBands, unsigned int seed) {
+	int numNodes = static_cast<int>(graph.size());
+	if (numNodes <= 1 || numBands <= 0) { return uniform(numNodes, count, seed); }
+
+	const float* xs = graph.xs();
+	const float* ys = graph.ys();
+	auto [minX, maxX] = std::minmax_element(xs, xs + numNodes);
+	auto [minY, maxY] = std::minmax_element(ys, ys + numNodes);
+	float diagonal = std::hypot(*maxX - *minX, *maxY - *minY);
+	if (diagonal <= 0.f) { return uniform(numNodes, count, seed); }
+
+	// Rejection sampling: draw uniform pairs and keep each only if its band still has room
+	std::vector<std::vector<Query>> bands(numBands);
+	int perBand = (count + numBands - 1) / numBands;
+	int numAccepted = 0;
+	long long maxDraws = static_cast<long long>(count) * 1000;
+
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> nodeDistribution(0, numNodes - 1);
+	for (long long draw = 0; draw < maxDraws && numAccepted < count; ++draw) {
+		int start = nodeDistribution(gen), goal = nodeDistribution(gen);
+		if (start == goal) { continue; }
+		float distance = std::hypot(xs[goal] - xs[start], ys[goal] - ys[start]);
+		int band = std::min(static_cast<int>(distance / diagonal * numBands), numBands - 1);
+		if (bands[band].size() < perBand) { bands[band].push_back(Query{ start, goal }); ++numAccepted; }
+	}
+
+	// Interleaved, so that any prefix of the set still covers every band
+	std::vector<Query> queries;
+	queries.reserve(numAccepted);
+	for (int i = 0; i < perBand; ++i) {
+		for (auto& band : bands) {
+			if (i < band.size() && queries.size() < count) { queries.push_back(band[i]); }
+		}
+	}
+	return QuerySet(queries);
+}
+
+std::optional<QuerySet> QuerySet::load(const std::filesystem::path& path, int numNodes, std::string& error) {
+	std::ifstream file(path);
+	if (!file.is_open()) { error = stringOut("No such file ", path.generic_string()); return std::nullopt; }
+
+	std::vector<Query> queries;
+	std::string line;
+	for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+		line = line.substr(0, line.find('#'));
+		std::stringstream stream(line);
+		int start, goal;
+		if (!(stream >> start)) { continue; }
+		if (!(stream >> goal)) { error = stringOut(path.generic_string(), ":", lineNumber, ": expected a start and a goal"); return std::nullopt; }
+		if (start < 0 || start >= numNodes || goal < 0 || goal >= numNodes) {
+			error = stringOut(path.generic_string(), ":", lineNumber, ": query ", start, " -> ", goal, " is outside the graph's ", numNodes, " nodes");
+			return std::nullopt;
+		}
+		queries.push_back(Query{ start, goal });
+	}
+	if (queries.empty()) { error = stringOut("No queries in ", path.generic_string()); return std::nullopt; }
+	return QuerySet(queries);
+}
+
+bool QuerySet::save(const std::filesystem::path& path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) { return false; }
+	file << "# start goal\n";
+	for (auto& query : m_queries) { file << query.start << ' ' << query.goal << '\n'; }
+	return file.good();
+}
+
+const std::vector<Query>& QuerySet::queries() const { return m_queries; }
+size_t QuerySet::size() const { return m_queries.size(); }
+bool QuerySet::empty() const { return m_queries.empty(); }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <optional>
+#include <filesystem>
+
+#include "../Graph/CompressedGraph.h"
+#include "../Maths/Vec2.h"
+
+struct Query { int start, goal; };
+
+// Reproducible set of start/goal pairs to profile over, so timings cover a spread of query lengths
+// instead of one pair repeated until it's unrealistically warm in the caches
+class QuerySet
+{
+public:
+	QuerySet() = default;
+	QuerySet(const std::vector<Query>& queries);
+
+	// Pairs drawn uniformly from every node, with start and goal distinct where the graph has more than one node
+	static QuerySet uniform(int numNodes, int count, unsigned int seed);
+	// Pairs split evenly between bands of straight-line distance, from zero up to the diagonal of the graph's bounding box,
+	// so short and long queries are equally represented. Bands too rare to fill within a fixed number of draws are left short
+	static QuerySet distanceBanded(const CompressedGraph<Vec2, float>& graph, int count, int numBands, unsigned int seed);
+	// One 'start goal' pair per line, with '#' starting a comment. Returns nothing and sets error if the file can't be read
+	// or names a node outside the graph
+	static std::optional<QuerySet> load(const std::filesystem::path& path, int numNodes, std::string& error);
+
+	// Same format as load
+	bool save(const std::filesystem::path& path) const;
+
+	const std::vector<Query>& queries() const;
+	size_t size() const;
+	bool empty() const;
+
+private:
+	std::vector<Query> m_queries;
+};
\ No newline at end of file
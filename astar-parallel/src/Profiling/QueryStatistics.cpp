@@ -0,0 +1,29 @@
+#include "QueryStatistics.h"
+
+#include <bit>
+
+using namespace std::chrono;
+
+QueryStatistics::QueryStatistics(const std::vector<TimeCompound>& times, const std::vector<size_t>& pathLengths) : m_overall(times) {
+	nanoseconds totalTime = nanoseconds(0);
+	for (auto& time : times) { totalTime += time.asNanosecondsFull(); }
+	if (totalTime.count() > 0) { m_throughput = static_cast<double>(times.size()) / duration<double>(totalTime).count(); }
+
+	// Bucket 0 holds length 0, bucket b lengths [2^(b-1), 2^b)
+	std::vector<std::vector<TimeCompound>> bucketTimes;
+	for (size_t i = 0; i < times.size() && i < pathLengths.size(); ++i) {
+		size_t bucket = std::bit_width(pathLengths[i]);
+		if (bucket >= bucketTimes.size()) { bucketTimes.resize(bucket + 1); }
+		bucketTimes[bucket].push_back(times[i]);
+	}
+	for (size_t bucket = 0; bucket < bucketTimes.size(); ++bucket) {
+		if (bucketTimes[bucket].empty()) { continue; }
+		size_t minLength = bucket == 0 ? 0 : size_t(1) << (bucket - 1);
+		size_t maxLength = bucket == 0 ? 0 : (size_t(1) << bucket) - 1;
+		m_buckets.push_back(LengthBucket{ minLength, maxLength, TimeStatistics(bucketTimes[bucket]) });
+	}
+}
+
+const TimeStatistics& QueryStatistics::overall() const { return m_overall; }
+double QueryStatistics::throughput() const { return m_throughput; }
+const std::vector<QueryStatistics::LengthBucket>& QueryStatistics::buckets() const { return m_buckets; }
\ No newline at end of file
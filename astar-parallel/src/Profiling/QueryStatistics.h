@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "Timer.h"
+#include "TimeStatistics.h"
+
+// Summary of a profiling run over a query set: throughput across the whole set, and latency broken down by the length of path found
+class QueryStatistics
+{
+public:
+	struct LengthBucket
+	{
+		// Range of path lengths, in nodes, inclusive
+		size_t minLength, maxLength;
+		TimeStatistics times;
+	};
+
+	// One time and one path length per query
+	QueryStatistics(const std::vector<TimeCompound>& times, const std::vector<size_t>& pathLengths);
+
+	const TimeStatistics& overall() const;
+	// Queries per second, from the total time spent searching
+	double throughput() const;
+	// Buckets doubling in path length (1, 2-3, 4-7, ...), after a bucket of length 0 for queries with no path. Empty ones are left out
+	const std::vector<LengthBucket>& buckets() const;
+
+private:
+	TimeStatistics m_overall;
+	double m_throughput = 0.0;
+	std::vector<LengthBucket> m_buckets;
+};
\ No newline at end of file
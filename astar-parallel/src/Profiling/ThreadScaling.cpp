@@ -0,0 +1,38 @@
+#include "ThreadScaling.h"
+
+#include <algorithm>
+
+ThreadScaling::ThreadScaling(const std::string& algorithmName, const std::string& baselineName) : m_algorithmName(algorithmName), m_baselineName(baselineName) {}
+
+std::vector<int> ThreadScaling::sweepThreadCounts(int maxThreads) {
+	std::vector<int> counts;
+	for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2) { counts.push_back(numThreads); }
+	counts.push_back(std::max(maxThreads, 1));
+	return counts;
+}
+
+void ThreadScaling::setBaseline(const TimeStatistics& times) {
+	m_baselineMean = times.mean();
+	m_baselineStandardDeviation = times.standardDeviation();
+}
+
+void ThreadScaling::addResult(int numThreads, const TimeStatistics& times) {
+	TimeCompound mean = times.mean();
+	double speedup = static_cast<double>(m_baselineMean.asNanosecondsFull().count()) / static_cast<double>(std::max(mean.asNanosecondsFull(), std::chrono::nanoseconds(1)).count());
+	m_results.push_back(Result{ numThreads, mean, times.standardDeviation(), speedup, speedup / numThreads });
+}
+
+const std::string& ThreadScaling::algorithmName() const { return m_algorithmName; }
+const std::string& ThreadScaling::baselineName() const { return m_baselineName; }
+TimeCompound ThreadScaling::baselineMean() const { return m_baselineMean; }
+const std::vector<ThreadScaling::Result>& ThreadScaling::results() const { return m_results; }
+
+void ThreadScaling::writeCSV(std::ostream& out) const {
+	out << "algorithm,threads,mean_ns,stddev_ns,speedup,efficiency\n";
+	// Baseline as its own row, at one thread, so the file stands on its own
+	out << m_baselineName << ",1," << m_baselineMean.asNanosecondsFull().count() << ',' << m_baselineStandardDeviation.asNanosecondsFull().count() << ",1,1\n";
+	for (auto& result : m_results) {
+		out << m_algorithmName << ',' << result.numThreads << ',' << result.mean.asNanosecondsFull().count() << ',' << result.standardDeviation.asNanosecondsFull().count()
+			<< ',' << result.speedup << ',' << result.efficiency << '\n';
+	}
+}
\ No newline at end of file
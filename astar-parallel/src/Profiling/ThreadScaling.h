@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "Timer.h"
+#include "TimeStatistics.h"
+
+// Timings of a parallel algorithm at a range of thread counts, compared against a sequential baseline.
+// Speedup is baseline mean over mean, and efficiency is speedup per thread, so 1 is perfect scaling
+class ThreadScaling
+{
+public:
+	struct Result
+	{
+		int numThreads;
+		TimeCompound mean, standardDeviation;
+		double speedup, efficiency;
+	};
+
+	ThreadScaling(const std::string& algorithmName, const std::string& baselineName);
+
+	// Powers of two up to maxThreads, ending with maxThreads itself
+	static std::vector<int> sweepThreadCounts(int maxThreads);
+
+	void setBaseline(const TimeStatistics& times);
+	// Must come after the baseline
+	void addResult(int numThreads, const TimeStatistics& times);
+
+	const std::string& algorithmName() const;
+	const std::string& baselineName() const;
+	TimeCompound baselineMean() const;
+	const std::vector<Result>& results() const;
+
+	void writeCSV(std::ostream&) const;
+
+private:
+	std::string m_algorithmName, m_baselineName;
+	TimeCompound m_baselineMean = TimeCompound(std::chrono::nanoseconds(0));
+	TimeCompound m_baselineStandardDeviation = TimeCompound(std::chrono::nanoseconds(0));
+	std::vector<Result> m_results;
+};
\ No newline at end of file
@@ -1,13 +1,49 @@
 #include "TimeStatistics.h"
-#include "queue"
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <bit>
 
 using namespace std::chrono;
 
-TimeStatistics::TimeStatistics(const std::vector<TimeCompound>& times) : m_times(times) {}
+namespace {
+	// Index of the nearest rank sample for a fraction of count samples
+	size_t nearestRank(double fraction, size_t count) {
+		size_t rank = static_cast<size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count)));
+		return std::max(rank, size_t(1)) - 1;
+	}
+
+	// Middle confidence fraction of the statistic over resamples of values drawn with replacement
+	template<class Statistic>
+	TimeStatistics::Interval bootstrap(const std::vector<nanoseconds>& values, Statistic&& statistic, double confidence, int numResamples, unsigned int seed) {
+		if (values.empty() || numResamples <= 0) { return TimeStatistics::Interval{ TimeCompound(nanoseconds(0)), TimeCompound(nanoseconds(0)) }; }
+
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution<size_t> sampleDistribution(0, values.size() - 1);
+		std::vector<nanoseconds> resample(values.size());
+		std::vector<nanoseconds> results;
+		results.reserve(numResamples);
+		for (int i = 0; i < numResamples; ++i) {
+			for (auto& value : resample) { value = values[sampleDistribution(gen)]; }
+			results.push_back(statistic(resample));
+		}
+
+		std::sort(results.begin(), results.end());
+		double tail = (1.0 - std::clamp(confidence, 0.0, 1.0)) / 2.0;
+		return TimeStatistics::Interval{ TimeCompound(results[nearestRank(tail, results.size())]), TimeCompound(results[nearestRank(1.0 - tail, results.size())]) };
+	}
+}
+
+TimeStatistics::TimeStatistics(const std::vector<TimeCompound>& times) : m_times(times) {
+	m_sorted.reserve(m_times.size());
+	for (auto& time : m_times) { m_sorted.push_back(time.asNanosecondsFull()); }
+	std::sort(m_sorted.begin(), m_sorted.end());
+}
 
 const std::vector<TimeCompound>& TimeStatistics::times() const { return m_times; }
 
 TimeCompound TimeStatistics::mean() const {
+	if (m_times.empty()) { return TimeCompound(nanoseconds(0)); }
 	nanoseconds sumTime = nanoseconds(0);
 	for (auto& time : m_times) { sumTime += time.asNanosecondsFull(); }
 
@@ -16,6 +52,7 @@ TimeCompound TimeStatistics::mean() const {
 }
 
 TimeCompound TimeStatistics::standardDeviation() const {
+	if (m_times.empty()) { return TimeCompound(nanoseconds(0)); }
 	nanoseconds meanTime = mean().asNanosecondsFull();
 	double sumSquareDifference = 0.0;
 	for (auto& time : m_times) { sumSquareDifference += pow(static_cast<double>((time.asNanosecondsFull() - meanTime).count()), 2); }
@@ -24,15 +61,72 @@ TimeCompound TimeStatistics::standardDeviation() const {
 }
 
 TimeCompound TimeStatistics::median() const {
-	std::priority_queue<nanoseconds> queue;
-	for (auto& time : m_times) { queue.push(time.asNanosecondsFull()); }
-	std::vector<nanoseconds> orderedTimes;
-	while (!queue.empty()) { orderedTimes.push_back(queue.top()); queue.pop(); }
-	
-	auto numValues = orderedTimes.size();
+	auto numValues = m_sorted.size();
+	if (numValues == 0) { return TimeCompound(nanoseconds(0)); }
+	// Middle value, or halfway between the two middle values for an even count
 	if (numValues % 2 == 0) {
-		nanoseconds below = orderedTimes.at(numValues / 2), above = orderedTimes.at((numValues / 2) + 1);
+		nanoseconds below = m_sorted[(numValues / 2) - 1], above = m_sorted[numValues / 2];
 		return TimeCompound(below + ((above - below) / 2));
 	}
-	else { return TimeCompound(orderedTimes.at((numValues / 2) + 1)); }
+	else { return TimeCompound(m_sorted[numValues / 2]); }
+}
+
+TimeCompound TimeStatistics::min() const { return m_sorted.empty() ? TimeCompound(nanoseconds(0)) : TimeCompound(m_sorted.front()); }
+TimeCompound TimeStatistics::max() const { return m_sorted.empty() ? TimeCompound(nanoseconds(0)) : TimeCompound(m_sorted.back()); }
+
+TimeCompound TimeStatistics::percentile(double fraction) const {
+	if (m_sorted.empty()) { return TimeCompound(nanoseconds(0)); }
+	return TimeCompound(m_sorted[nearestRank(fraction, m_sorted.size())]);
+}
+
+TimeCompound TimeStatistics::interquartileRange() const {
+	return TimeCompound(percentile(0.75).asNanosecondsFull() - percentile(0.25).asNanosecondsFull());
+}
+
+TimeStatistics::Interval TimeStatistics::meanConfidenceInterval(double confidence, int numResamples, unsigned int seed) const {
+	return bootstrap(m_sorted, [](const std::vector<nanoseconds>& resample) {
+		nanoseconds sum = nanoseconds(0);
+		for (auto& value : resample) { sum += value; }
+		return sum / resample.size();
+	}, confidence, numResamples, seed);
+}
+
+TimeStatistics::Interval TimeStatistics::percentileConfidenceInterval(double fraction, double confidence, int numResamples, unsigned int seed) const {
+	// A full sort per resample isn't needed for a single rank
+	return bootstrap(m_sorted, [fraction](std::vector<nanoseconds>& resample) {
+		auto nth = resample.begin() + nearestRank(fraction, resample.size());
+		std::nth_element(resample.begin(), nth, resample.end());
+		return *nth;
+	}, confidence, numResamples, seed);
+}
+
+std::vector<TimeStatistics::HistogramBucket> TimeStatistics::histogram(int subBucketsPerDoubling) const {
+	std::vector<HistogramBucket> buckets;
+	if (m_sorted.empty()) { return buckets; }
+	// Power of two, so each sub-bucket of a doubling is a whole number of nanoseconds wide (or one, below subBucketsPerDoubling)
+	unsigned long long subBuckets = std::bit_ceil(static_cast<unsigned long long>(std::max(subBucketsPerDoubling, 1)));
+	int subBucketBits = std::countr_zero(subBuckets);
+
+	// Times below subBuckets get a bucket each. Above that, the doubling [2^e, 2^(e+1)) is split into subBuckets buckets 2^e / subBuckets wide
+	auto bucketOf = [&](unsigned long long value) -> unsigned long long {
+		if (value < subBuckets) { return value; }
+		int exponent = std::bit_width(value) - 1;
+		unsigned long long subBucket = (value - (1ull << exponent)) >> (exponent - subBucketBits);
+		return subBuckets + static_cast<unsigned long long>(exponent - subBucketBits) * subBuckets + subBucket;
+	};
+	auto lowerBoundOf = [&](unsigned long long bucket) -> unsigned long long {
+		if (bucket < subBuckets) { return bucket; }
+		int exponent = static_cast<int>((bucket - subBuckets) / subBuckets) + subBucketBits;
+		unsigned long long subBucket = (bucket - subBuckets) % subBuckets;
+		return (1ull << exponent) + (subBucket << (exponent - subBucketBits));
+	};
+
+	auto clampedCount = [](nanoseconds time) { return static_cast<unsigned long long>(std::max<long long>(time.count(), 0)); };
+	unsigned long long first = bucketOf(clampedCount(m_sorted.front())), last = bucketOf(clampedCount(m_sorted.back()));
+	buckets.reserve(last - first + 1);
+	for (unsigned long long bucket = first; bucket <= last; ++bucket) {
+		buckets.push_back(HistogramBucket{ nanoseconds(lowerBoundOf(bucket)), nanoseconds(lowerBoundOf(bucket + 1)), 0 });
+	}
+	for (auto& time : m_sorted) { ++buckets[bucketOf(clampedCount(time)) - first].count; }
+	return buckets;
 }
\ No newline at end of file
@@ -2,10 +2,15 @@
 
 #include "Timer.h"
 #include <vector>
+#include <chrono>
 
 class TimeStatistics
 {
 public:
+	struct Interval { TimeCompound lower, upper; };
+	// Times from lower up to but not including upper
+	struct HistogramBucket { std::chrono::nanoseconds lower, upper; size_t count; };
+
 	TimeStatistics(const std::vector<TimeCompound>& times);
 
 	const std::vector<TimeCompound>& times() const;
@@ -13,7 +18,25 @@ public:
 	TimeCompound mean() const;
 	TimeCompound standardDeviation() const;
 	TimeCompound median() const;
+	TimeCompound min() const;
+	TimeCompound max() const;
+	// Time at or below which the given fraction of samples fall (by nearest rank), eg. 0.99 for the 99th percentile
+	TimeCompound percentile(double fraction) const;
+	// Spread of the middle half of the samples, from the 25th to the 75th percentile
+	TimeCompound interquartileRange() const;
+
+	// Bootstrap confidence intervals: the statistic is recomputed over numResamples resamples of the times, drawn with replacement,
+	// and the interval is the middle confidence fraction of the results. Seeded, so the same times always give the same interval
+	Interval meanConfidenceInterval(double confidence = 0.95, int numResamples = 1000, unsigned int seed = 0) const;
+	Interval percentileConfidenceInterval(double fraction, double confidence = 0.95, int numResamples = 1000, unsigned int seed = 0) const;
+
+	// Log-bucketed histogram, as in HdrHistogram: each power of two range of times is split into subBucketsPerDoubling buckets of equal
+	// width, so buckets widen as times grow and every bucket has the same relative precision. Runs from the bucket holding the
+	// shortest time to the one holding the longest, including any empty buckets in between
+	std::vector<HistogramBucket> histogram(int subBucketsPerDoubling = 8) const;
 
 private:
 	std::vector<TimeCompound> m_times;
+	// Sorted once up front, which every order statistic then reads from directly
+	std::vector<std::chrono::nanoseconds> m_sorted;
 };
\ No newline at end of file
@@ -12,6 +12,23 @@ DirectedGraph<Vec2, float>& Singleton::graph() {
 	return GetInstance().m_graph;
 }
 
+const CompressedGraph<Vec2, float>& Singleton::compressedGraph() {
+	auto& instance = GetInstance();
+	if (instance.m_compressedGraph.sourceRevision() != instance.m_graph.revision()) {
+		instance.m_compressedGraph = CompressedGraph<Vec2, float>(instance.m_graph);
+	}
+	return instance.m_compressedGraph;
+}
+
+void Singleton::adoptCompressedGraph(CompressedGraph<Vec2, float>&& compressedGraph) {
+	GetInstance().m_compressedGraph = std::move(compressedGraph);
+}
+
+void Singleton::releaseMappedGraph() {
+	auto& instance = GetInstance();
+	if (instance.m_compressedGraph.backing()) { instance.m_compressedGraph = CompressedGraph<Vec2, float>(); }
+}
+
 Path& Singleton::path() {
 	return GetInstance().m_path;
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Graph/DirectedGraph.h"
+#include "Graph/CompressedGraph.h"
 #include "Maths/Vec2.h"
 #include "Pathfinding/Prototypes.h"
 #include <string>
@@ -8,6 +9,12 @@ class Singleton
 {
 public:
 	static DirectedGraph<Vec2, float>& graph();
+	// Frozen copy of graph() used for pathfinding, rebuilt whenever graph() has been modified since it was last requested
+	static const CompressedGraph<Vec2, float>& compressedGraph();
+	// Use an existing compressed copy of graph() (eg. a memory-mapped file it was loaded from) instead of building one
+	static void adoptCompressedGraph(CompressedGraph<Vec2, float>&& compressedGraph);
+	// Stop viewing a memory-mapped file as compressedGraph(), so the file can be replaced. It's rebuilt from graph() when next requested
+	static void releaseMappedGraph();
 	static Path& path();
 
 	static void recalculateEdgeWeights();
@@ -22,6 +29,7 @@ private:
 	static Singleton& GetInstance();
 
 	DirectedGraph<Vec2, float> m_graph;
+	CompressedGraph<Vec2, float> m_compressedGraph;
 	Path m_path;
 
 	bool m_currentlyProfiling = false;
@@ -0,0 +1,142 @@
+#include "ThreadPool.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+struct ThreadPool::SavedAffinity
+{
+#ifdef _WIN32
+	GROUP_AFFINITY affinity;
+#else
+	cpu_set_t set;
+#endif
+};
+
+ThreadPool::~ThreadPool() {
+	{
+		auto lock = std::lock_guard(m_mutex);
+		m_stopping = true;
+	}
+	m_jobAvailable.notify_all();
+	for (auto& worker : m_workers) { worker.join(); }
+}
+
+ThreadPool& ThreadPool::shared() {
+	static ThreadPool pool;
+	return pool;
+}
+
+int ThreadPool::numWorkers() {
+	auto lock = std::lock_guard(m_runMutex);
+	return static_cast<int>(m_workers.size());
+}
+
+void ThreadPool::setPinThreads(bool pin) { m_pinThreads = pin; }
+
+bool ThreadPool::pinThreads() const { return m_pinThreads; }
+
+void ThreadPool::runErased(int numTasks, TaskFunc func, void* data) {
+	if (numTasks <= 0) { return; }
+
+	auto runLock = std::lock_guard(m_runMutex);
+
+	// Task 0 is run by the caller, so we need a worker for each of the others
+	while (m_workers.size() < numTasks - 1) {
+		int workerIndex = static_cast<int>(m_workers.size());
+		m_workers.emplace_back(&ThreadPool::workerLoop, this, workerIndex);
+	}
+
+	{
+		auto lock = std::lock_guard(m_mutex);
+		m_taskFunc = func; m_taskData = data;
+		m_numTasks = numTasks;
+		m_numTasksRemaining = numTasks - 1;
+		++m_jobGeneration;
+	}
+	m_jobAvailable.notify_all();
+
+	// The caller isn't ours to keep pinned, so it's put back how it was once its task is done
+	SavedAffinity callerAffinity;
+	bool callerPinned = m_pinThreads && pinCurrentThread(0, callerAffinity);
+	func(data, 0);
+	if (callerPinned) { restoreCurrentThread(callerAffinity); }
+
+	auto lock = std::unique_lock(m_mutex);
+	m_jobFinished.wait(lock, [this]() { return m_numTasksRemaining == 0; });
+}
+
+void ThreadPool::workerLoop(int workerIndex) {
+	// Worker n runs task n + 1, since task 0 belongs to the caller
+	int taskIndex = workerIndex + 1;
+	unsigned long long lastGeneration = 0;
+	bool pinned = false;
+	SavedAffinity savedAffinity;
+
+	while (true) {
+		TaskFunc func; void* data;
+		{
+			auto lock = std::unique_lock(m_mutex);
+			m_jobAvailable.wait(lock, [&]() { return m_stopping || m_jobGeneration != lastGeneration; });
+			if (m_stopping) { return; }
+			lastGeneration = m_jobGeneration;
+			// Not every job needs every worker
+			if (taskIndex >= m_numTasks) { continue; }
+			func = m_taskFunc; data = m_taskData;
+		}
+
+		bool pin = m_pinThreads;
+		if (pin && !pinned) { pinned = pinCurrentThread(taskIndex, savedAffinity); }
+		else if (!pin && pinned) { restoreCurrentThread(savedAffinity); pinned = false; }
+
+		func(data, taskIndex);
+
+		bool lastToFinish;
+		{
+			auto lock = std::lock_guard(m_mutex);
+			lastToFinish = (--m_numTasksRemaining == 0);
+		}
+		if (lastToFinish) { m_jobFinished.notify_one(); }
+	}
+}
+
+bool ThreadPool::pinCurrentThread(int coreIndex, SavedAffinity& saved) {
+#ifdef _WIN32
+	// Cores are numbered across every processor group, since one affinity mask only covers the (up to 64) cores of a single group
+	DWORD numCores = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+	if (numCores == 0) { return false; }
+	DWORD core = static_cast<DWORD>(coreIndex) % numCores;
+	WORD numGroups = GetActiveProcessorGroupCount();
+	WORD group = 0;
+	while (group + 1 < numGroups && core >= GetActiveProcessorCount(group)) { core -= GetActiveProcessorCount(group); ++group; }
+	GROUP_AFFINITY affinity{};
+	affinity.Group = group;
+	affinity.Mask = static_cast<KAFFINITY>(1) << core;
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, &saved.affinity) != 0;
+#else
+	if (pthread_getaffinity_np(pthread_self(), sizeof(saved.set), &saved.set) != 0) { return false; }
+	// Cores are numbered among those the thread is already allowed on, so any restriction from outside (eg. taskset) is kept to
+	int numAllowed = CPU_COUNT(&saved.set);
+	if (numAllowed == 0) { return false; }
+	int remaining = coreIndex % numAllowed;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+		if (CPU_ISSET(cpu, &saved.set) && remaining-- == 0) { CPU_SET(cpu, &set); break; }
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
+
+void ThreadPool::restoreCurrentThread(const SavedAffinity& saved) {
+#ifdef _WIN32
+	SetThreadGroupAffinity(GetCurrentThread(), &saved.affinity, nullptr);
+#else
+	pthread_setaffinity_np(pthread_self(), sizeof(saved.set), &saved.set);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Long-lived set of worker threads which parallel algorithms hand their per-thread work to, instead of spawning
+// and joining threads on every call. Workers are parked on a condition variable between jobs.
+class ThreadPool
+{
+public:
+	ThreadPool() = default;
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Pool shared by the pathfinding algorithms
+	static ThreadPool& shared();
+
+	// Call func(taskIndex) for every taskIndex in [0, numTasks) concurrently, and block until they have all returned.
+	// Task 0 runs on the calling thread, and the pool grows to fit so every task has its own thread, which means tasks are
+	// free to wait on each other. Only one job runs at a time; calling run from inside a task will deadlock.
+	template<class Func>
+	void run(int numTasks, Func& func) {
+		runErased(numTasks, [](void* funcPtr, int taskIndex) { (*static_cast<Func*>(funcPtr))(taskIndex); }, &func);
+	}
+
+	int numWorkers();
+
+	// Whether to pin each thread of a job to its own core, the calling thread included. Workers stay pinned until this is turned off,
+	// when they're given back the affinity they had before; the caller is only pinned while it runs task 0. Takes effect from the next job
+	void setPinThreads(bool pin);
+	bool pinThreads() const;
+
+private:
+	using TaskFunc = void(*)(void*, int);
+
+	std::vector<std::thread> m_workers;
+
+	// Held for the duration of a job so concurrent callers queue up rather than interleave
+	std::mutex m_runMutex;
+
+	// Protects everything below, which describes the current job
+	std::mutex m_mutex;
+	std::condition_variable m_jobAvailable, m_jobFinished;
+	unsigned long long m_jobGeneration = 0;
+	TaskFunc m_taskFunc = nullptr; void* m_taskData = nullptr;
+	int m_numTasks = 0;
+	int m_numTasksRemaining = 0;
+	bool m_stopping = false;
+
+	std::atomic<bool> m_pinThreads = false;
+
+	void runErased(int numTasks, TaskFunc func, void* data);
+	void workerLoop(int workerIndex);
+
+	// Affinity a thread had before being pinned, so it can be put back. Platform specific, so only defined in the source file
+	struct SavedAffinity;
+	// Pin the calling thread to a single core, saving its previous affinity. Returns whether it was pinned
+	static bool pinCurrentThread(int coreIndex, SavedAffinity& saved);
+	static void restoreCurrentThread(const SavedAffinity& saved);
+};
\ No newline at end of file
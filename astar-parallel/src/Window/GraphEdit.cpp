@@ -3,9 +3,11 @@
 
 #include "../Singleton.h"
 #include <string>
+#include <random>
 #include "../StringUtil.h"
 
 #include "../Graph/GraphJSON.h"
+#include "../Graph/GraphBinary.h"
 
 #include "../Graph/GraphDisplay.h"
 #include "../Graph/GenerateGraph.h"
@@ -18,12 +20,31 @@ GraphEdit::GraphEdit() {
 }
 
 void GraphEdit::saveGraph(std::string path) {
-	auto resultingPath = saveToFile(Singleton::graph(), path);
-	m_saveLoadMessage.setMessage("Saved to " + resultingPath.generic_string());
-	Singleton::consoleOutput(stringOut("Saved graph to file at local path ", resultingPath));
+	bool binary = std::filesystem::path(path).extension() == ".graph";
+	// The graph may have been loaded from the very file being saved over, which can't be replaced while it's still mapped
+	if (binary) { Singleton::releaseMappedGraph(); }
+	std::string error;
+	auto resultingPath = binary ? saveToBinaryFile(Singleton::graph(), path, error) : saveToFile(Singleton::graph(), path, error, m_saveCompact);
+	if (!resultingPath) { m_saveLoadMessage.setMessage(error, true); return; }
+	m_saveLoadMessage.setMessage("Saved to " + resultingPath->generic_string());
+	Singleton::consoleOutput(stringOut("Saved graph to ", (binary ? "binary" : "JSON"), " file at local path ", *resultingPath));
 }
 
 void GraphEdit::loadGraph(std::string path) {
+	// Binary files are recognised by their magic bytes whatever they're called. Anything else is read as JSON
+	if (isBinaryGraphFile(path)) {
+		auto loaded = loadFromBinaryFile<Vec2, float>(path);
+		if (loaded) {
+			Singleton::graph() = loaded->first;
+			Singleton::adoptCompressedGraph(std::move(loaded->second));
+			Singleton::path() = Path();
+			m_saveLoadMessage.setMessage("Loaded from " + path);
+			Singleton::consoleOutput(stringOut("Loaded graph from binary file at local path ", path));
+		}
+		else { m_saveLoadMessage.setMessage("Invalid binary graph " + path, true); }
+		return;
+	}
+
 	auto [loadedGraph, resultingPath] = loadFromFile<Vec2, float>(path);
 	if (loadedGraph.size() != 0) {
 		Singleton::graph() = loadedGraph;
@@ -44,11 +65,11 @@ NodeDisplayInfo GraphEdit::getNodeInfo(const Vec2& val, const int& index) {
 void GraphEdit::generateGraph() {
 	Singleton::graph() = GenerateKNearest(m_generate_numNodes, m_generate_k,
 		Vec2(m_generate_lowerBound[0], m_generate_lowerBound[1]), Vec2(m_generate_upperBound[0], m_generate_upperBound[1]),
-		m_heuristics[m_heuristicIndex].first, m_generate_doubleEdged);
+		m_heuristics[m_heuristicIndex].first, static_cast<unsigned int>(m_generate_seed), m_generate_doubleEdged);
 	Singleton::recalculateEdgeWeights();
 	Singleton::path() = Path();
 	Singleton::consoleOutput(stringOut("Generated ", (m_generate_doubleEdged ? " double-edged " : ""), "k-nearest graph with size=",
-		m_generate_numNodes, " and k=", m_generate_k, " using heuristic ", m_heuristics.at(m_heuristicIndex).second, "."));
+		m_generate_numNodes, ", k=", m_generate_k, " and seed=", m_generate_seed, " using heuristic ", m_heuristics.at(m_heuristicIndex).second, "."));
 }
 
 void GraphEdit::addMenuBarItem() {
@@ -96,9 +117,9 @@ void GraphEdit::imguiDrawWindow(int width, int height) {
 	}
 
 	if (m_showSaveLoadDialog) {
-		float popupWidth = 200, popupHeight = 100;
+		float popupWidth = 200, popupHeight = (m_saveLoadDialogIsSave) ? 125 : 100;
 		ImGui::SetNextWindowPos({ width / 2.f - popupWidth / 2.f, height / 2.f - popupHeight / 2.f }, ImGuiCond_Once);
-		ImGui::SetNextWindowSize(ImVec2(popupWidth, popupHeight), ImGuiCond_Once);
+		ImGui::SetNextWindowSize(ImVec2(popupWidth, popupHeight), ImGuiCond_Always);
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1.f);
 		const char* label = (m_saveLoadDialogIsSave) ? "Save" : "Load";
 		ImGui::Begin(label, &m_showSaveLoadDialog, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoResize);
@@ -113,7 +134,12 @@ void GraphEdit::imguiDrawWindow(int width, int height) {
 		if (ImGui::InputText("##filepathInput", m_inputSavePath, IM_ARRAYSIZE(m_inputSavePath), ImGuiInputTextFlags_EnterReturnsTrue)) {
 			buttonOrEnterPressed();
 		}
+		if (m_saveLoadDialogIsSave) { ImGui::SetItemTooltip("Saved as JSON, or in binary format if the name ends in .graph."); }
 		if (ImGui::IsWindowFocused() && !ImGui::IsAnyItemActive() && !ImGui::IsMouseClicked(0) && !Singleton::currentlyProfiling()) { ImGui::SetKeyboardFocusHere(-1); }
+		if (m_saveLoadDialogIsSave) {
+			ImGui::Checkbox("Compact JSON", &m_saveCompact);
+			ImGui::SetItemTooltip("Leave out all whitespace. Otherwise each node and edge goes on its own indented line.");
+		}
 		ImGui::PushID("##saveloadbutton");
 		if (ImGui::Button(label, ImVec2(100, 20))) {
 			buttonOrEnterPressed();
@@ -127,7 +153,7 @@ void GraphEdit::imguiDrawWindow(int width, int height) {
 	}
 
 	if (m_showGenerateDialog) {
-		float popupWidth = 350, popupHeight = 195;
+		float popupWidth = 350, popupHeight = 220;
 		ImGui::SetNextWindowPos({ width / 2.f - popupWidth / 2.f, height / 2.f - popupHeight / 2.f }, ImGuiCond_Once);
 		ImGui::SetNextWindowSize(ImVec2(popupWidth, popupHeight), ImGuiCond_Once);
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1.f);
@@ -142,6 +168,14 @@ void GraphEdit::imguiDrawWindow(int width, int height) {
 		ImGui::PopID();
 		ImGui::InputFloat2("Lower Bound", m_generate_lowerBound);
 		ImGui::InputFloat2("Upper Bound", m_generate_upperBound);
+		ImGui::SetNextItemWidth(150);
+		ImGui::InputInt("Seed", &m_generate_seed);
+		ImGui::SameLine();
+		if (ImGui::Button("Randomise", ImVec2(100, 20))) {
+			std::random_device rd;
+			m_generate_seed = static_cast<int>(rd() & 0x7fffffff);
+		}
+		ImGui::SetItemTooltip("Generating with the same seed and settings always gives the same graph.");
 
 		ImGui::SetNextItemWidth(comboWidth);
 		if (ImGui::BeginCombo("##heuristicCombo", m_heuristics[m_heuristicIndex].second.c_str())) {
@@ -39,6 +39,7 @@ private:
 	bool m_showSaveLoadDialog = false;
 	bool m_saveLoadDialogIsSave = true;
 	char m_inputSavePath[256];
+	bool m_saveCompact = true;
 	OutputMessage m_saveLoadMessage;
 
 	bool m_showGraphAdjacencyTableWindow = false;
@@ -48,9 +49,10 @@ private:
 	int m_generate_numNodes = 30;
 	int m_generate_k = 5;
 	bool m_generate_doubleEdged = false;
+	int m_generate_seed = 0;
 	float m_generate_lowerBound[2] = { -100.f, -100.f };
 	float m_generate_upperBound[2] = { 100.f, 100.f };
 
-	std::vector<std::pair<Heuristic<Vec2,float>, std::string>> m_heuristics;
+	std::vector<std::pair<DistanceFunction<Vec2,float>, std::string>> m_heuristics;
 	int m_heuristicIndex = 0;
 };
\ No newline at end of file
@@ -2,31 +2,116 @@
 
 #include "../Singleton.h"
 #include "../../imgui/imgui.h"
+#include <extensions/implot/implot.h>
 
 #include "../Pathfinding/AStar.h"
 #include "../Pathfinding/HDAStar.h"
+#include "../Pathfinding/HDAStarMessagePassing.h"
+#include "../Pathfinding/BidirectionalAStar.h"
+#include "../Pathfinding/ParallelBidirectionalAStar.h"
 #include "../Pathfinding/Heuristics.h"
 
 #include "../StringUtil.h"
 #include "../Pathfinding/PathStream.h"
+#include "../Threading/ThreadPool.h"
 
 #include "../Window/Window.h"
+#include "../Profiling/QueryStatistics.h"
 
 #include <random>
+#include <algorithm>
+#include <fstream>
 
 PathfindingSettings::PathfindingSettings() {
-	m_algorithms.emplace_back(aStarSequential<Vec2, float>, "A* Sequential");
-	m_algorithms.emplace_back(hashDistributedAStarSharedMemory<Vec2, float>, "HDA* Parallel Shared Memory");
+	// Heuristics go first, so the algorithms can be specialised on those with functor versions
+	m_euclideanHeuristicIndex = static_cast<int>(m_heuristics.size());
+	m_heuristics.emplace_back(distanceHeuristic(euclideanDistance), "Euclidean Distance");
+	m_manhattanHeuristicIndex = static_cast<int>(m_heuristics.size());
+	m_heuristics.emplace_back(distanceHeuristic(manhattanDistance), "Manhattan Distance");
+	m_landmarkHeuristicIndex = static_cast<int>(m_heuristics.size());
+	m_heuristics.emplace_back([this](const CompressedGraph<Vec2, float>&, int from, int to) { return m_landmarks.lowerBound(from, to); }, "Landmarks (ALT)");
 
-	m_heuristics.emplace_back(euclideanDistance, "Euclidean Distance");
-	m_heuristics.emplace_back(manhattanDistance, "Manhattan Distance");
+	m_sequentialAlgorithmIndex = static_cast<int>(m_algorithms.size());
+	addSpecialisedAlgorithm([](const auto& graph, int start, int goal, const auto& heuristic, auto& context) { return aStarSequential(graph, start, goal, heuristic, context); }, "A* Sequential");
+	addSpecialisedAlgorithm([](const auto& graph, int start, int goal, const auto& heuristic, auto& context) { return aStarSequential<CompressedGraph<Vec2, float>, RadixHeapOpenSet>(graph, start, goal, heuristic, context); }, "A* Sequential (Radix Heap)");
+	addSpecialisedAlgorithm([](const auto& graph, int start, int goal, const auto& heuristic, auto& context) { return hashDistributedAStarSharedMemory(graph, start, goal, heuristic, context); }, "HDA* Parallel Shared Memory", true);
+	addSpecialisedAlgorithm([](const auto& graph, int start, int goal, const auto& heuristic, auto& context) { return hashDistributedAStarMessagePassing(graph, start, goal, heuristic, context); }, "HDA* Parallel Message Passing", true);
+	addSpecialisedAlgorithm([](const auto& graph, int start, int goal, const auto& heuristic, auto& context) { return bidirectionalAStar(graph, start, goal, heuristic, context); }, "Bidirectional A* (NBA*)");
+	addSpecialisedAlgorithm([](const auto& graph, int start, int goal, const auto& heuristic, auto& context) { return parallelBidirectionalAStar(graph, start, goal, heuristic, context); }, "Bidirectional A* Parallel (PNBA*)");
+	// Thread count applies to building the hierarchy, which happens before the first search rather than as part of each one
+	m_contractionHierarchyAlgorithmIndex = static_cast<int>(m_algorithms.size());
+	addAlgorithm([this](const CompressedGraph<Vec2, float>&, int start, int goal, const Heuristic<Vec2, float>&, SearchContext<float>& context) {
+		return m_contractionHierarchy.query(start, goal, context);
+	}, "Contraction Hierarchy", true);
 }
 
-const PathfindingAlgorithm<Vec2, float>& PathfindingSettings::getCurrentAlgorithm() const { return m_algorithms[m_algorithmIndex].first; }
+void PathfindingSettings::addAlgorithm(const PathfindingAlgorithm<Vec2, float>& algorithm, const std::string& name, bool usesThreadCount) {
+	m_algorithms.emplace_back(algorithm, name);
+	m_algorithmUsesThreadCount.push_back(usesThreadCount);
+	m_specialisedAlgorithms.emplace_back();
+}
+
+template<class Search>
+void PathfindingSettings::addSpecialisedAlgorithm(const Search& search, const std::string& name, bool usesThreadCount) {
+	// General version, which takes whichever heuristic it's passed
+	addAlgorithm([search](const CompressedGraph<Vec2, float>& graph, int start, int goal, const Heuristic<Vec2, float>& heuristic, SearchContext<float>& context) {
+		return search(graph, start, goal, heuristic, context);
+	}, name, usesThreadCount);
+
+	// Versions which ignore the heuristic passed and use a functor in its place, one per heuristic that has one
+	auto specialise = [&search](auto heuristicFunctor) -> PathfindingAlgorithm<Vec2, float> {
+		return [search, heuristicFunctor](const CompressedGraph<Vec2, float>& graph, int start, int goal, const Heuristic<Vec2, float>&, SearchContext<float>& context) {
+			return search(graph, start, goal, heuristicFunctor, context);
+		};
+	};
+	auto& specialised = m_specialisedAlgorithms.back();
+	specialised.resize(m_heuristics.size());
+	specialised[m_euclideanHeuristicIndex] = specialise(DistanceHeuristic<EuclideanDistance>());
+	specialised[m_manhattanHeuristicIndex] = specialise(DistanceHeuristic<ManhattanDistance>());
+}
+
+const PathfindingAlgorithm<Vec2, float>& PathfindingSettings::getCurrentAlgorithm() const { return getAlgorithm(m_algorithmIndex); }
+const PathfindingAlgorithm<Vec2, float>& PathfindingSettings::getAlgorithm(int algorithmIndex) const {
+	// Prefer the version specialised on the current heuristic, if there is one
+	auto& specialised = m_specialisedAlgorithms[algorithmIndex];
+	if (m_heuristicIndex < specialised.size() && specialised[m_heuristicIndex]) { return specialised[m_heuristicIndex]; }
+	return m_algorithms[algorithmIndex].first;
+}
 const Heuristic<Vec2, float>& PathfindingSettings::getCurrentHeuristic() const { return m_heuristics[m_heuristicIndex].first; }
 
+void PathfindingSettings::prepareAlgorithm() {
+	if (m_algorithmIndex != m_contractionHierarchyAlgorithmIndex) { return; }
+
+	auto& graph = Singleton::compressedGraph();
+	if (m_contractionHierarchyBuilt && m_contractionHierarchyRevision == graph.sourceRevision()) { return; }
+
+	int numThreads = g_numThreads > 0 ? g_numThreads : std::thread::hardware_concurrency();
+	Timer timer;
+	timer.start();
+	m_contractionHierarchy = ContractionHierarchy<float>(graph, numThreads);
+	timer.stop();
+	m_contractionHierarchyRevision = graph.sourceRevision();
+	m_contractionHierarchyBuilt = true;
+	Singleton::consoleOutput(stringOut("Built contraction hierarchy with ", m_contractionHierarchy.numShortcuts(), " shortcuts in ", timer.elapsedTime(), " using ", numThreads, " threads."));
+}
+
+void PathfindingSettings::prepareHeuristic() {
+	if (m_heuristicIndex != m_landmarkHeuristicIndex) { return; }
+
+	auto& graph = Singleton::compressedGraph();
+	if (!m_landmarksDirty && m_landmarksRevision == graph.sourceRevision()) { return; }
+
+	LandmarkSelection selection = m_landmarkSelection == 0 ? LandmarkSelection::Farthest : LandmarkSelection::Avoid;
+	m_landmarks = Landmarks<float>(graph, m_numLandmarks, selection);
+	m_landmarksRevision = graph.sourceRevision();
+	m_landmarksDirty = false;
+	Singleton::consoleOutput(stringOut("Precomputed distances for ", m_landmarks.landmarks().size(), " landmarks using ", (m_landmarkSelection == 0 ? "farthest" : "avoid"), " selection."));
+}
+
 bool PathfindingSettings::findPath() {
-	Singleton::path() = getCurrentAlgorithm()(Singleton::graph(), m_startIndex, m_goalIndex, getCurrentHeuristic());
+	prepareAlgorithm();
+	prepareHeuristic();
+	Singleton::path() = getCurrentAlgorithm()(Singleton::compressedGraph(), m_startIndex, m_goalIndex, getCurrentHeuristic(), m_searchContext);
 	if (Singleton::path().size() > 0) {
 		Singleton::consoleOutput(stringOut("Found path of length ", Singleton::path().size(), " from node ", m_startIndex, " to node ", m_goalIndex,
 			" using ", m_algorithms.at(m_algorithmIndex).second, " with heuristic ", m_heuristics.at(m_heuristicIndex).second, "."));
@@ -43,34 +128,189 @@ bool PathfindingSettings::findPath() {
 
 void PathfindingSettings::startProfiling() {
 	m_profilerMessage.clear();
+	m_profilerResults.reset();
+	if (!prepareQuerySet()) { return; }
+	prepareAlgorithm();
+	prepareHeuristic();
 	Singleton::currentlyProfiling() = true;
-	Singleton::consoleOutput(stringOut("Beginning ", (m_profilerBlocking ? "blocking" : "non-blocking"), " profiling session with ", m_profilerIterations, " iterations."));
+	if (m_profilerQuerySet.empty()) {
+		Singleton::consoleOutput(stringOut("Beginning ", (m_profilerBlocking ? "blocking" : "non-blocking"), " profiling session with ", m_profilerIterations, " iterations."));
+	}
+	else {
+		Singleton::consoleOutput(stringOut("Beginning ", (m_profilerBlocking ? "blocking" : "non-blocking"), " profiling session over ", m_profilerQuerySet.size(), " queries."));
+	}
 	Singleton::consoleOutput(stringOut("Algorithm: ", m_algorithms.at(m_algorithmIndex).second));
 	Singleton::consoleOutput(stringOut("Heuristic: ", m_heuristics.at(m_heuristicIndex).second));
+
+	m_sweepStage = -1;
+	if (m_profilerSweepThreads && canSweepThreads()) {
+		m_sweepThreadCounts = ThreadScaling::sweepThreadCounts(std::thread::hardware_concurrency());
+		m_threadScaling.emplace(m_algorithms.at(m_algorithmIndex).second, m_algorithms.at(m_sequentialAlgorithmIndex).second);
+		m_threadScalingMessage.clear();
+		m_threadsBeforeSweep = g_numThreads;
+		m_sweepStage = 0;
+		Singleton::consoleOutput(stringOut("Sweeping from 1 to ", m_sweepThreadCounts.back(), " threads, against ", m_threadScaling->baselineName(), "."));
+	}
+	startProfilingStage();
+}
+
+bool PathfindingSettings::sweeping() const { return m_sweepStage >= 0; }
+// Contraction hierarchy only uses threads to build the hierarchy, so its searches wouldn't scale
+bool PathfindingSettings::canSweepThreads() const { return m_algorithmUsesThreadCount[m_algorithmIndex] && m_algorithmIndex != m_contractionHierarchyAlgorithmIndex; }
+
+void PathfindingSettings::startProfilingStage() {
+	// First stage of a sweep profiles the baseline, then each stage after profiles the current algorithm at the next thread count
+	const PathfindingAlgorithm<Vec2, float>* algorithm = &getCurrentAlgorithm();
+	if (sweeping()) {
+		if (m_sweepStage == 0) {
+			algorithm = &getAlgorithm(m_sequentialAlgorithmIndex);
+			Singleton::consoleOutput(stringOut("Profiling baseline ", m_threadScaling->baselineName(), "."));
+		}
+		else {
+			g_numThreads = m_sweepThreadCounts[m_sweepStage - 1];
+			Singleton::consoleOutput(stringOut("Profiling with ", g_numThreads, " threads."));
+		}
+	}
+	// Algorithms which don't record stats leave them empty, rather than showing those of whichever algorithm ran before
+	m_searchContext.stats().clear();
+
+	// Each query in a query set is one iteration
+	bool profileQuerySet = !m_profilerQuerySet.empty();
+	int numIterations = profileQuerySet ? static_cast<int>(m_profilerQuerySet.size()) : m_profilerIterations;
+	auto& queries = m_profilerQuerySet.queries();
+
 	if (m_profilerBlocking) {
-		m_profiler = std::make_unique<ProfilerBlocking>(m_profilerIterations);
-		((ProfilerBlocking*)m_profiler.get())->performProfiling(getCurrentAlgorithm(), Singleton::graph(), m_startIndex, m_goalIndex, getCurrentHeuristic());
-		finalProfilerMessage();
+		m_profiler = std::make_unique<ProfilerBlocking>(numIterations);
+		m_profiler->setIterationCallback(Window::requestRedrawThreadsafe);
+		auto profiler = (ProfilerBlocking*)m_profiler.get();
+		if (profileQuerySet) { profiler->performQueryProfiling(*algorithm, queries, std::cref(Singleton::compressedGraph()), getCurrentHeuristic(), std::ref(m_searchContext)); }
+		else { profiler->performProfiling(*algorithm, std::cref(Singleton::compressedGraph()), m_startIndex, m_goalIndex, getCurrentHeuristic(), std::ref(m_searchContext)); }
+		profilingStageComplete();
 	}
 	else {
-		m_profiler = std::make_unique<ProfilerNonBlocking>(m_profilerIterations);
-		((ProfilerNonBlocking*)m_profiler.get())->startProfiling(getCurrentAlgorithm(), std::cref(Singleton::graph()), m_startIndex, m_goalIndex, getCurrentHeuristic());
+		m_profiler = std::make_unique<ProfilerNonBlocking>(numIterations);
+		m_profiler->setIterationCallback(Window::requestRedrawThreadsafe);
+		auto profiler = (ProfilerNonBlocking*)m_profiler.get();
+		if (profileQuerySet) { profiler->startQueryProfiling(*algorithm, queries, std::cref(Singleton::compressedGraph()), getCurrentHeuristic(), std::ref(m_searchContext)); }
+		else { profiler->startProfiling(*algorithm, std::cref(Singleton::compressedGraph()), m_startIndex, m_goalIndex, getCurrentHeuristic(), std::ref(m_searchContext)); }
+	}
+}
+
+bool PathfindingSettings::prepareQuerySet() {
+	auto& graph = Singleton::compressedGraph();
+	int numNodes = static_cast<int>(graph.size());
+	unsigned int seed = static_cast<unsigned int>(m_profilerQuerySeed);
+
+	auto queries = static_cast<ProfilerQueries>(m_profilerQueries);
+	if (queries == ProfilerQueries::StartAndGoal) { m_profilerQuerySet = QuerySet(); return true; }
+	else if (queries == ProfilerQueries::Uniform) { m_profilerQuerySet = QuerySet::uniform(numNodes, m_profilerNumQueries, seed); }
+	else if (queries == ProfilerQueries::DistanceBanded) { m_profilerQuerySet = QuerySet::distanceBanded(graph, m_profilerNumQueries, m_profilerQueryBands, seed); }
+	else {
+		std::string error;
+		auto loaded = QuerySet::load(m_profilerQueryPath, numNodes, error);
+		if (!loaded) { m_profilerMessage.setMessage(error, true); return false; }
+		m_profilerQuerySet = std::move(*loaded);
+	}
+
+	if (m_profilerQuerySet.empty()) { m_profilerMessage.setMessage("Graph is empty", true); return false; }
+	if (queries == ProfilerQueries::DistanceBanded && m_profilerQuerySet.size() < m_profilerNumQueries) {
+		Singleton::consoleOutput(stringOut("Only found ", m_profilerQuerySet.size(), " of ", m_profilerNumQueries, " queries, as some distance bands are too rare to fill."));
+	}
+	return true;
+}
+
+void PathfindingSettings::saveQuerySet() {
+	if (!prepareQuerySet()) { return; }
+	if (m_profilerQuerySet.save(m_profilerQueryPath)) {
+		m_profilerMessage.setMessage("Saved.");
+		Singleton::consoleOutput(stringOut("Saved ", m_profilerQuerySet.size(), " queries to ", m_profilerQueryPath, "."));
+	}
+	else { m_profilerMessage.setMessage("Couldn't open file", true); }
+}
+
+void PathfindingSettings::profilingStageComplete() {
+	if (!sweeping()) { finalProfilerMessage(); return; }
+
+	auto timeStats = m_profiler->timingResults();
+	if (m_sweepStage == 0) { m_threadScaling->setBaseline(timeStats); }
+	else { m_threadScaling->addResult(m_sweepThreadCounts[m_sweepStage - 1], timeStats); }
+
+	++m_sweepStage;
+	if (m_sweepStage <= m_sweepThreadCounts.size()) { startProfilingStage(); return; }
+
+	m_sweepStage = -1;
+	g_numThreads = m_threadsBeforeSweep;
+	Singleton::currentlyProfiling() = false;
+	m_profilerMessage.setMessage("Sweep complete.");
+	Singleton::consoleOutput("Sweep complete.");
+	Singleton::consoleOutput(stringOut("Baseline mean: ", m_threadScaling->baselineMean(), " / ", m_threadScaling->baselineMean().asSecondsFull(), " seconds"));
+	for (auto& result : m_threadScaling->results()) {
+		Singleton::consoleOutput(stringOut(result.numThreads, " threads: mean ", result.mean, ", speedup ", result.speedup, ", efficiency ", result.efficiency));
 	}
+	Singleton::consoleOutput("");
+}
+
+void PathfindingSettings::exportThreadScaling() {
+	std::string path(m_threadScalingExportPath);
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) { m_threadScalingMessage.setMessage("Couldn't open file", true); return; }
+	m_threadScaling->writeCSV(file);
+	m_threadScalingMessage.setMessage("Exported.");
+	Singleton::consoleOutput(stringOut("Exported thread scaling results to ", path, "."));
 }
 
 void PathfindingSettings::finalProfilerMessage() {
 	Singleton::currentlyProfiling() = false;
 	m_profilerMessage.setMessage("Profiling complete.");
 	Singleton::consoleOutput("Profiling complete.");
-	Singleton::consoleOutput("Results:");
 	auto timeStats = m_profiler->timingResults();
-	for (auto& time : timeStats.times()) {
-		Singleton::consoleOutput(stringOut(time.asSecondsFull(), " seconds / ", time));
+	if (m_profiler->resultSizes().empty()) {
+		Singleton::consoleOutput("Results:");
+		for (auto& time : timeStats.times()) {
+			Singleton::consoleOutput(stringOut(time.asSecondsFull(), " seconds / ", time));
+		}
+	}
+	else {
+		// Far too many to list every query, so break them down by path length instead
+		QueryStatistics queryStats(timeStats.times(), m_profiler->resultSizes());
+		Singleton::consoleOutput(stringOut("Results over ", timeStats.times().size(), " queries:"));
+		Singleton::consoleOutput(stringOut("Throughput: ", queryStats.throughput(), " queries per second"));
+		for (auto& bucket : queryStats.buckets()) {
+			std::string lengths = bucket.maxLength == 0 ? "No path" :
+				(bucket.minLength == bucket.maxLength ? stringOut("Path length ", bucket.minLength) : stringOut("Path length ", bucket.minLength, "-", bucket.maxLength));
+			Singleton::consoleOutput(stringOut(lengths, ": ", bucket.times.times().size(), " queries, p50 ", bucket.times.percentile(0.5), ", p90 ", bucket.times.percentile(0.9),
+				", p99 ", bucket.times.percentile(0.99), ", max ", bucket.times.max()));
+		}
 	}
 	Singleton::consoleOutput("");
 	Singleton::consoleOutput(stringOut("Median: ", timeStats.median(), " / ", timeStats.median().asSecondsFull(), " seconds"));
-	Singleton::consoleOutput(stringOut("Mean: ", timeStats.mean(), " / ", timeStats.mean().asSecondsFull(), " seconds"));
+	auto meanInterval = timeStats.meanConfidenceInterval();
+	Singleton::consoleOutput(stringOut("Mean: ", timeStats.mean(), " / ", timeStats.mean().asSecondsFull(), " seconds (95% CI ", meanInterval.lower, " to ", meanInterval.upper, ")"));
 	Singleton::consoleOutput(stringOut("Standard Deviation: ", timeStats.standardDeviation(), " / ", timeStats.standardDeviation().asSecondsFull(), " seconds"));
+	Singleton::consoleOutput(stringOut("Min: ", timeStats.min(), " / Max: ", timeStats.max(), " / Interquartile Range: ", timeStats.interquartileRange()));
+	auto p99Interval = timeStats.percentileConfidenceInterval(0.99);
+	Singleton::consoleOutput(stringOut("p50: ", timeStats.percentile(0.5), " / p90: ", timeStats.percentile(0.9), " / p99: ", timeStats.percentile(0.99),
+		" (95% CI ", p99Interval.lower, " to ", p99Interval.upper, ") / p99.9: ", timeStats.percentile(0.999)));
+	m_profilerResults = timeStats;
+
+	// Only available when built with ASTAR_SEARCH_STATS, see SearchStats.h
+	auto& searchStats = m_searchContext.stats();
+	if (searchStatsEnabled && !searchStats.empty()) {
+		ThreadSearchStats total = searchStats.total();
+		Singleton::consoleOutput("");
+		Singleton::consoleOutput("Search statistics (final iteration):");
+		Singleton::consoleOutput(stringOut("Nodes expanded: ", total.nodesExpanded, " (", total.reExpansions, " re-expansions)"));
+		Singleton::consoleOutput(stringOut("Edges relaxed: ", total.edgesRelaxed));
+		Singleton::consoleOutput(stringOut("Open set peak: ", total.openSetPeak, (searchStats.threads().size() > 1 ? " (sum of each thread's peak)" : "")));
+		if (searchStats.threads().size() > 1) {
+			Singleton::consoleOutput(stringOut("Lock wait: ", TimeCompound(total.lockWait), " / Idle: ", TimeCompound(total.idleWait)));
+			for (int i = 0; i < searchStats.threads().size(); ++i) {
+				auto& thread = searchStats.threads()[i];
+				Singleton::consoleOutput(stringOut("Thread ", i, ": ", thread.nodesExpanded, " expanded, ", thread.edgesRelaxed, " relaxed, open set peak ", thread.openSetPeak,
+					", lock wait ", TimeCompound(thread.lockWait), ", idle ", TimeCompound(thread.idleWait)));
+			}
+		}
+	}
 }
 
 void PathfindingSettings::checkOnProfiling() {
@@ -79,16 +319,18 @@ void PathfindingSettings::checkOnProfiling() {
 	ProfilerNonBlocking* ptr = (ProfilerNonBlocking*)m_profiler.get();
 
 	if (ptr->isFinished()) {
-		finalProfilerMessage();
+		// Either finishes profiling or starts the next stage of a sweep
+		profilingStageComplete();
 		// Have to request one more time or it won't show the final message until an input event is recieved
 		Window::requestRedrawThreadsafe();
 	}
 	else {
 		int jobsCompleted = ptr->jobsCompleted();
-		double percentage = (static_cast<double>(jobsCompleted) / static_cast<double>(m_profilerIterations)) * 100;
+		double percentage = (static_cast<double>(jobsCompleted) / static_cast<double>(ptr->numIterations())) * 100;
 		int percentageRounded = static_cast<int>(round(percentage));
 
-		m_profilerMessage.setMessage(stringOut("Completed ", percentageRounded, "% (", jobsCompleted, "/", m_profilerIterations, ")"));
+		std::string stage = sweeping() ? stringOut("Stage ", m_sweepStage + 1, "/", m_sweepThreadCounts.size() + 1, ": ") : "";
+		m_profilerMessage.setMessage(stringOut(stage, "Completed ", percentageRounded, "% (", jobsCompleted, "/", ptr->numIterations(), ")"));
 	}
 }
 
@@ -118,7 +360,7 @@ void PathfindingSettings::imguiDrawWindow(int width, int height) {
 	bool disabled = Singleton::currentlyProfiling();
 
 	if (m_showSettingsDialog) {
-		float popupWidth = 300, popupHeight = 140;
+		float popupWidth = 300, popupHeight = 215;
 		ImGui::SetNextWindowPos({ width / 2.f - popupWidth / 2.f, height / 2.f - popupHeight / 2.f }, ImGuiCond_Once);
 		ImGui::SetNextWindowSize(ImVec2(popupWidth, popupHeight), ImGuiCond_Once);
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1.f);
@@ -154,9 +396,24 @@ void PathfindingSettings::imguiDrawWindow(int width, int height) {
 			}
 			ImGui::EndCombo();
 		}
-		if (m_algorithmIndex == 0) { ImGui::BeginDisabled(); }
+		bool usesLandmarks = m_heuristicIndex == m_landmarkHeuristicIndex;
+		if (!usesLandmarks) { ImGui::BeginDisabled(); }
+		ImGui::SetNextItemWidth(100);
+		if (ImGui::InputInt("Landmarks", &m_numLandmarks)) { m_numLandmarks = std::max(m_numLandmarks, 1); m_landmarksDirty = true; }
+		ImGui::SetNextItemWidth(100);
+		if (ImGui::Combo("Landmark selection", &m_landmarkSelection, "Farthest\0Avoid\0")) { m_landmarksDirty = true; }
+		ImGui::SetItemTooltip("Farthest spreads landmarks around the edges of the graph.\nAvoid places them where the current landmarks give the worst bounds.");
+		if (!usesLandmarks) { ImGui::EndDisabled(); }
+		bool usesThreadCount = m_algorithmUsesThreadCount[m_algorithmIndex];
+		if (!usesThreadCount) { ImGui::BeginDisabled(); }
 		ImGui::InputInt("Threads", &g_numThreads);
-		if (m_algorithmIndex == 0) { ImGui::EndDisabled(); }
+		bool pinThreads = ThreadPool::shared().pinThreads();
+		if (ImGui::Checkbox("Pin threads to cores", &pinThreads)) { ThreadPool::shared().setPinThreads(pinThreads); }
+		ImGui::SetItemTooltip("Whether to lock each worker thread in the pool to its own CPU core.");
+		bool prefillHeuristic = m_searchContext.heuristicCache().prefill();
+		if (ImGui::Checkbox("Prefill heuristic", &prefillHeuristic)) { m_searchContext.heuristicCache().setPrefill(prefillHeuristic); }
+		ImGui::SetItemTooltip("Whether HDA* evaluates the heuristic for every node at the start of a search, in vectorised batches,\nrather than for each node as it's reached. Faster when a search touches most of the graph.");
+		if (!usesThreadCount) { ImGui::EndDisabled(); }
 
 		if (disabled) { ImGui::EndDisabled(); }
 		ImGui::End();
@@ -164,28 +421,133 @@ void PathfindingSettings::imguiDrawWindow(int width, int height) {
 	}
 
 	if (m_showProfilingDialog) {
-		float popupWidth = 300, popupHeight = 120;
+		// Grows to fit the plot once there are thread scaling results to show
+		// and to fit the query set settings
+		bool showThreadScaling = m_threadScaling && !m_threadScaling->results().empty();
+		bool showHistogram = m_profilerResults && !m_profilerResults->times().empty();
+		auto queries = static_cast<ProfilerQueries>(m_profilerQueries);
+		bool generatedQueries = queries == ProfilerQueries::Uniform || queries == ProfilerQueries::DistanceBanded;
+		int numQueryRows = generatedQueries ? (queries == ProfilerQueries::DistanceBanded ? 4 : 3) : (queries == ProfilerQueries::File ? 1 : 0);
+		float popupWidth = (showThreadScaling || showHistogram) ? 420.f : 300.f;
+		float popupHeight = 145.f + 24.f * (1 + numQueryRows) + (showHistogram ? 235.f : 0.f) + (showThreadScaling ? 300.f : 0.f);
 		ImGui::SetNextWindowPos({ width / 2.f - popupWidth / 2.f, height / 2.f - popupHeight / 2.f }, ImGuiCond_Once);
-		ImGui::SetNextWindowSize(ImVec2(popupWidth, popupHeight), ImGuiCond_Once);
+		ImGui::SetNextWindowSize(ImVec2(popupWidth, popupHeight), ImGuiCond_Always);
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 1.f);
 		ImGui::Begin("Profiling", &m_showProfilingDialog, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoResize);
 		if (disabled) { ImGui::BeginDisabled(); }
 
+		if (queries != ProfilerQueries::StartAndGoal) { ImGui::BeginDisabled(); }
 		ImGui::SetNextItemWidth(100);
 		ImGui::InputInt("Number of iterations", &m_profilerIterations, 100, 1000);
+		if (queries != ProfilerQueries::StartAndGoal) { ImGui::EndDisabled(); }
 		ImGui::Checkbox("Blocking", &m_profilerBlocking);
 		ImGui::SetItemTooltip("Whether to launch from a detached thread.\n(Blocking is potentially more accurate but causes window to freeze.)");
+		bool canSweep = canSweepThreads();
+		if (!canSweep) { ImGui::BeginDisabled(); }
+		ImGui::Checkbox("Sweep thread counts", &m_profilerSweepThreads);
+		ImGui::SetItemTooltip("Profile A* Sequential, then the current algorithm with 1, 2, 4, ... threads up to one per core,\nand compare them to find the speedup and parallel efficiency at each thread count.");
+		if (!canSweep) { ImGui::EndDisabled(); }
+
+		ImGui::SetNextItemWidth(140);
+		ImGui::Combo("Queries", &m_profilerQueries, "Start and goal\0Uniform random\0Distance banded\0From file\0");
+		ImGui::SetItemTooltip("Start and goal repeats the current query for every iteration.\nThe others run each query in a set once, and report throughput and latency by path length.");
+		if (generatedQueries) {
+			ImGui::SetNextItemWidth(100);
+			if (ImGui::InputInt("Number of queries", &m_profilerNumQueries, 100, 1000)) { m_profilerNumQueries = std::max(m_profilerNumQueries, 1); }
+			ImGui::SetNextItemWidth(100);
+			ImGui::InputInt("Seed", &m_profilerQuerySeed);
+			ImGui::SetItemTooltip("The same seed gives the same queries on the same graph.");
+		}
+		if (queries == ProfilerQueries::DistanceBanded) {
+			ImGui::SetNextItemWidth(100);
+			if (ImGui::InputInt("Distance bands", &m_profilerQueryBands)) { m_profilerQueryBands = std::max(m_profilerQueryBands, 1); }
+			ImGui::SetItemTooltip("Queries are split evenly between bands of straight-line distance from start to goal.");
+		}
+		if (queries != ProfilerQueries::StartAndGoal) {
+			ImGui::SetNextItemWidth(180);
+			ImGui::InputText("##profilerQueryPath", m_profilerQueryPath, IM_ARRAYSIZE(m_profilerQueryPath));
+			ImGui::SetItemTooltip("One 'start goal' pair per line.");
+			if (generatedQueries) {
+				ImGui::SameLine();
+				if (ImGui::Button("Save", ImVec2(60, 20))) { saveQuerySet(); }
+			}
+		}
+
 		if (ImGui::Button("Begin", ImVec2(100, 20))) {
 			startProfiling();
 		}
 		m_profilerMessage.draw();
 
+		if (showHistogram) { imguiDrawTimeHistogram(); }
+		if (showThreadScaling) { imguiDrawThreadScaling(); }
+
 		if (disabled) { ImGui::EndDisabled(); }
 		ImGui::End();
 		ImGui::PopStyleVar();
 	}
 }
 
+void PathfindingSettings::imguiDrawTimeHistogram() {
+	// Stairs need one more point than there are buckets, to close off the last one. Times in microseconds on a log scale,
+	// on which the log-sized buckets come out evenly spaced
+	auto buckets = m_profilerResults->histogram();
+	std::vector<double> edges, counts;
+	for (auto& bucket : buckets) {
+		edges.push_back(std::max<long long>(bucket.lower.count(), 1) / 1000.0);
+		counts.push_back(static_cast<double>(bucket.count));
+	}
+	edges.push_back(buckets.back().upper.count() / 1000.0);
+	counts.push_back(counts.back());
+
+	double markers[] = { m_profilerResults->percentile(0.5).asNanosecondsFull().count() / 1000.0, m_profilerResults->percentile(0.99).asNanosecondsFull().count() / 1000.0 };
+
+	ImGui::Separator();
+	ImGui::Text("Latency distribution");
+	if (ImPlot::BeginPlot("##timeHistogram", ImVec2(-1, 200))) {
+		ImPlot::SetupAxes("Time (us)", "Count", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+		ImPlot::SetupLegend(ImPlotLocation_NorthEast);
+
+		ImPlot::PlotStairs("Times", edges.data(), counts.data(), static_cast<int>(edges.size()), ImPlotStairsFlags_Shaded);
+		ImPlot::PlotInfLines("p50 / p99", markers, 2);
+		ImPlot::EndPlot();
+	}
+}
+
+void PathfindingSettings::imguiDrawThreadScaling() {
+	auto& results = m_threadScaling->results();
+	std::vector<double> threads, speedup, efficiency;
+	for (auto& result : results) {
+		threads.push_back(result.numThreads);
+		speedup.push_back(result.speedup);
+		efficiency.push_back(result.efficiency);
+	}
+
+	ImGui::Separator();
+	ImGui::Text("%s against %s", m_threadScaling->algorithmName().c_str(), m_threadScaling->baselineName().c_str());
+	if (ImPlot::BeginPlot("##threadScaling", ImVec2(-1, 250))) {
+		ImPlotAxisFlags axisFlags = ImPlotAxisFlags_AutoFit;
+		ImPlot::SetupAxes("Threads", "Speedup", axisFlags, axisFlags);
+		ImPlot::SetupAxis(ImAxis_Y2, "Efficiency", axisFlags | ImPlotAxisFlags_AuxDefault);
+		ImPlot::SetupLegend(ImPlotLocation_NorthWest);
+
+		// Perfect scaling, where speedup matches thread count
+		ImPlot::PlotLine("Linear", threads.data(), threads.data(), static_cast<int>(threads.size()));
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+		ImPlot::PlotLine("Speedup", threads.data(), speedup.data(), static_cast<int>(threads.size()));
+		ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Square);
+		ImPlot::PlotLine("Efficiency", threads.data(), efficiency.data(), static_cast<int>(threads.size()));
+		ImPlot::EndPlot();
+	}
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::InputText("##threadScalingExportPath", m_threadScalingExportPath, IM_ARRAYSIZE(m_threadScalingExportPath));
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV", ImVec2(100, 20))) { exportThreadScaling(); }
+	m_threadScalingMessage.draw();
+}
+
 void PathfindingSettings::imguiDrawControlGroup() {
 	ImGui::BeginGroup();
 	if (Singleton::currentlyProfiling()) { ImGui::BeginDisabled(); }
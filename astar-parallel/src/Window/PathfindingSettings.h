@@ -4,7 +4,12 @@
 #include <functional>
 #include "../Maths/Vec2.h"
 #include "../Pathfinding/Prototypes.h"
+#include "../Pathfinding/Landmarks.h"
+#include "../Pathfinding/ContractionHierarchy.h"
 #include "../Profiling/Profiler.h"
+#include "../Profiling/ThreadScaling.h"
+#include "../Profiling/QuerySet.h"
+#include <optional>
 #include <memory>
 
 #include "ImGuiUtil.h"
@@ -28,6 +33,7 @@ public:
 	void setIndices(int, int);
 
 	const PathfindingAlgorithm<Vec2, float>& getCurrentAlgorithm() const;
+	const PathfindingAlgorithm<Vec2, float>& getAlgorithm(int algorithmIndex) const;
 	const Heuristic<Vec2, float>& getCurrentHeuristic() const;
 
 private:
@@ -38,9 +44,45 @@ private:
 
 	std::vector<std::pair<Heuristic<Vec2,float>, std::string>> m_heuristics;
 	int m_heuristicIndex = 0;
+	int m_euclideanHeuristicIndex = -1;
+	int m_manhattanHeuristicIndex = -1;
+
+	// Tables for the landmark heuristic, rebuilt before a search whenever the graph or landmark settings have changed
+	Landmarks<float> m_landmarks;
+	int m_landmarkHeuristicIndex = -1;
+	int m_numLandmarks = 8;
+	int m_landmarkSelection = 0;
+	unsigned long long m_landmarksRevision = 0;
+	bool m_landmarksDirty = true;
+
+	void prepareHeuristic();
 
 	std::vector<std::pair<PathfindingAlgorithm<Vec2,float>, std::string>> m_algorithms;
+	std::vector<bool> m_algorithmUsesThreadCount;
 	int m_algorithmIndex = 1;
+	// Sequential A*, which thread scaling is measured against
+	int m_sequentialAlgorithmIndex = -1;
+
+	// Versions of each algorithm specialised on the functor form of a heuristic, indexed by heuristic, so the heuristic can be inlined
+	// into the search instead of called through a std::function. Empty where there's no specialisation, meaning use the general version
+	std::vector<std::vector<PathfindingAlgorithm<Vec2, float>>> m_specialisedAlgorithms;
+
+	void addAlgorithm(const PathfindingAlgorithm<Vec2, float>& algorithm, const std::string& name, bool usesThreadCount = false);
+	// Search is a generic lambda forwarding to an algorithm template, which is instantiated once for the general Heuristic
+	// and once for each heuristic functor
+	template<class Search>
+	void addSpecialisedAlgorithm(const Search& search, const std::string& name, bool usesThreadCount = false);
+
+	// Preprocessed hierarchy queried by the contraction hierarchy algorithm, rebuilt before a search whenever the graph has changed
+	ContractionHierarchy<float> m_contractionHierarchy;
+	int m_contractionHierarchyAlgorithmIndex = -1;
+	unsigned long long m_contractionHierarchyRevision = 0;
+	bool m_contractionHierarchyBuilt = false;
+
+	void prepareAlgorithm();
+
+	// Shared by every query launched from here, including each profiler iteration
+	SearchContext<float> m_searchContext;
 
 	bool m_showProfilingDialog = false;
 	int m_profilerIterations = 100;
@@ -48,6 +90,39 @@ private:
 	std::unique_ptr<Profiler> m_profiler = nullptr;
 	OutputMessage m_profilerMessage;
 
+	// What to profile over: the current start and goal repeated for every iteration, or a set of queries each run once
+	enum class ProfilerQueries { StartAndGoal, Uniform, DistanceBanded, File };
+	int m_profilerQueries = 0;
+	int m_profilerNumQueries = 1000;
+	int m_profilerQuerySeed = 0;
+	int m_profilerQueryBands = 8;
+	char m_profilerQueryPath[256] = "queries.txt";
+	// Built from the settings above when profiling begins. Empty when profiling the start and goal
+	QuerySet m_profilerQuerySet;
+
+	bool prepareQuerySet();
+	void saveQuerySet();
+
+	// Results of the last profiling session, plotted as a histogram. Not kept for thread scaling sweeps, which have their own plot
+	std::optional<TimeStatistics> m_profilerResults;
+	void imguiDrawTimeHistogram();
+
+	// Thread scaling sweep: sequential A* as a baseline, then the current algorithm at each thread count, each profiled in turn
+	bool m_profilerSweepThreads = false;
+	std::optional<ThreadScaling> m_threadScaling;
+	std::vector<int> m_sweepThreadCounts;
+	int m_sweepStage = -1;
+	int m_threadsBeforeSweep = 0;
+	char m_threadScalingExportPath[256] = "thread_scaling.csv";
+	OutputMessage m_threadScalingMessage;
+
+	bool sweeping() const;
+	bool canSweepThreads() const;
+	void startProfilingStage();
+	void profilingStageComplete();
+	void exportThreadScaling();
+	void imguiDrawThreadScaling();
+
 	void finalProfilerMessage();
 	void checkOnProfiling();
 };
\ No newline at end of file